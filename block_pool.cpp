@@ -0,0 +1,75 @@
+#include "block_pool.h"
+#include <algorithm>
+
+namespace voxel {
+
+    BlockPool::BlockPool(size_t blockSize, size_t alignment, size_t blocksPerSlab)
+        : m_alignment(std::max(alignment, alignof(FreeBlock)))
+        , m_blocksPerSlab(std::max<size_t>(blocksPerSlab, 1))
+        , m_freeList(nullptr)
+        , m_liveCount(0)
+    {
+        // Free blocks hold the list link, and every block stays aligned inside a slab
+        blockSize = std::max(blockSize, sizeof(FreeBlock));
+        m_blockSize = (blockSize + m_alignment - 1) / m_alignment * m_alignment;
+    }
+
+    BlockPool::~BlockPool() {
+        releaseAll();
+    }
+
+    void* BlockPool::allocate() {
+        if (!m_freeList) {
+            addSlab();
+        }
+
+        FreeBlock* block = m_freeList;
+        m_freeList = block->next;
+        m_liveCount++;
+        return block;
+    }
+
+    void BlockPool::release(void* block) {
+        if (!block) return;
+
+        FreeBlock* freeBlock = static_cast<FreeBlock*>(block);
+        freeBlock->next = m_freeList;
+        m_freeList = freeBlock;
+        m_liveCount--;
+    }
+
+    void BlockPool::releaseAll() {
+        for (void* slab : m_slabs) {
+            ::operator delete(slab, std::align_val_t(m_alignment));
+        }
+
+        m_slabs.clear();
+        m_freeList = nullptr;
+        m_liveCount = 0;
+    }
+
+    size_t BlockPool::getBlockSize() const {
+        return m_blockSize;
+    }
+
+    size_t BlockPool::getLiveCount() const {
+        return m_liveCount;
+    }
+
+    size_t BlockPool::getSlabCount() const {
+        return m_slabs.size();
+    }
+
+    void BlockPool::addSlab() {
+        char* slab = static_cast<char*>(::operator new(m_blockSize * m_blocksPerSlab, std::align_val_t(m_alignment)));
+        m_slabs.push_back(slab);
+
+        // Thread the new blocks onto the free list in address order
+        for (size_t i = m_blocksPerSlab; i-- > 0;) {
+            FreeBlock* block = reinterpret_cast<FreeBlock*>(slab + i * m_blockSize);
+            block->next = m_freeList;
+            m_freeList = block;
+        }
+    }
+
+} // namespace voxel
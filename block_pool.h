@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace voxel {
+
+    // Fixed-size block allocator. Blocks are carved out of large slabs and recycled
+    // through an intrusive free list, so once the pool has grown to its working size
+    // allocate() and release() never touch the general-purpose heap. Not thread safe.
+    class BlockPool {
+    public:
+        BlockPool(size_t blockSize, size_t alignment, size_t blocksPerSlab);
+        ~BlockPool();
+
+        BlockPool(const BlockPool&) = delete;
+        BlockPool& operator=(const BlockPool&) = delete;
+
+        void* allocate();
+        void release(void* block);
+
+        // Frees every slab in one go. Blocks still handed out become invalid, so any
+        // objects in them must have been destroyed (or need no destruction).
+        void releaseAll();
+
+        size_t getBlockSize() const;
+        size_t getLiveCount() const;
+        size_t getSlabCount() const;
+
+    private:
+        struct FreeBlock {
+            FreeBlock* next;
+        };
+
+        void addSlab();
+
+        size_t m_blockSize;
+        size_t m_alignment;
+        size_t m_blocksPerSlab;
+        std::vector<void*> m_slabs;
+        FreeBlock* m_freeList;
+        size_t m_liveCount;
+    };
+
+    // Typed front end of a BlockPool: constructs objects in pooled blocks
+    template <typename T>
+    class ObjectPool {
+    public:
+        explicit ObjectPool(size_t objectsPerSlab = 64)
+            : m_blocks(sizeof(T), alignof(T), objectsPerSlab)
+        {
+        }
+
+        template <typename... Args>
+        T* create(Args&&... args) {
+            void* block = m_blocks.allocate();
+            return new (block) T(std::forward<Args>(args)...);
+        }
+
+        void destroy(T* object) {
+            if (!object) return;
+
+            object->~T();
+            m_blocks.release(object);
+        }
+
+        // See BlockPool::releaseAll
+        void releaseAll() {
+            m_blocks.releaseAll();
+        }
+
+        size_t getLiveCount() const {
+            return m_blocks.getLiveCount();
+        }
+
+    private:
+        BlockPool m_blocks;
+    };
+
+} // namespace voxel
@@ -87,6 +87,10 @@ namespace renderer {
         return glm::perspective(glm::radians(m_fov), m_aspectRatio, m_nearPlane, m_farPlane);
     }
 
+    Frustum Camera::getFrustum() const {
+        return Frustum::fromMatrix(getProjectionMatrix() * getViewMatrix());
+    }
+
     void Camera::setPerspective(float fov, float aspectRatio, float nearPlane, float farPlane) {
         m_fov = fov;
         m_aspectRatio = aspectRatio;
@@ -112,5 +116,40 @@ namespace renderer {
             << m_front.x << ", " << m_front.y << ", " << m_front.z << ")" << std::endl;
     }
 
+    Frustum Frustum::fromMatrix(const glm::mat4& viewProjection) {
+        // Rows of the matrix; clip space -w <= x, y, z <= w gives one plane per inequality
+        glm::vec4 row0(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+        glm::vec4 row1(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+        glm::vec4 row2(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+        glm::vec4 row3(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+
+        Frustum frustum;
+        frustum.planes[FRUSTUM_LEFT] = row3 + row0;
+        frustum.planes[FRUSTUM_RIGHT] = row3 - row0;
+        frustum.planes[FRUSTUM_BOTTOM] = row3 + row1;
+        frustum.planes[FRUSTUM_TOP] = row3 - row1;
+        frustum.planes[FRUSTUM_NEAR] = row3 + row2;
+        frustum.planes[FRUSTUM_FAR] = row3 - row2;
+
+        for (auto& plane : frustum.planes) {
+            plane /= glm::length(glm::vec3(plane));
+        }
+
+        return frustum;
+    }
+
+    bool Frustum::containsBox(const glm::vec3& min, const glm::vec3& max) const {
+        // The box is outside once its corner furthest along a plane normal is behind it
+        for (const auto& plane : planes) {
+            glm::vec3 corner(
+                plane.x > 0.0f ? max.x : min.x,
+                plane.y > 0.0f ? max.y : min.y,
+                plane.z > 0.0f ? max.z : min.z);
+
+            if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f) return false;
+        }
+        return true;
+    }
+
 } // namespace renderer
 
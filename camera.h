@@ -4,6 +4,27 @@
 
 namespace renderer {
 
+    // Six planes bounding the visible volume, in FrustumPlane order. Each plane is
+    // (normal, distance) with the normal pointing inwards and normalized, so a point p
+    // is inside when dot(normal, p) + distance >= 0 for every plane.
+    enum FrustumPlane {
+        FRUSTUM_LEFT = 0,
+        FRUSTUM_RIGHT,
+        FRUSTUM_BOTTOM,
+        FRUSTUM_TOP,
+        FRUSTUM_NEAR,
+        FRUSTUM_FAR
+    };
+
+    struct Frustum {
+        glm::vec4 planes[6];
+
+        // Extracts the planes from a view-projection matrix (OpenGL clip space)
+        static Frustum fromMatrix(const glm::mat4& viewProjection);
+
+        bool containsBox(const glm::vec3& min, const glm::vec3& max) const;
+    };
+
     class Camera {
     public:
         Camera();
@@ -28,6 +49,9 @@ namespace renderer {
         glm::mat4 getProjectionMatrix() const;
         void setPerspective(float fov, float aspectRatio, float nearPlane, float farPlane);
 
+        // Frustum of projection * view in world space
+        Frustum getFrustum() const;
+
     private:
         void updateCameraVectors();
 
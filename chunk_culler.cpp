@@ -0,0 +1,151 @@
+#include "chunk_culler.h"
+#include "voxel_chunk.h"
+#include <bit>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CHUNK_CULLER_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace voxel {
+
+    namespace {
+
+        // A frustum plane with the box coordinates that lie furthest along its normal
+        struct CullPlane {
+            float nx, ny, nz, d;
+            const float* x;
+            const float* y;
+            const float* z;
+        };
+
+    } // namespace
+
+    void ChunkCuller::setBox(VoxelChunk* chunk, const glm::vec3& min, const glm::vec3& max) {
+        int slot = chunk->getCullSlot();
+        if (slot < 0) {
+            slot = static_cast<int>(m_chunks.size());
+            chunk->setCullSlot(slot);
+
+            m_chunks.push_back(chunk);
+            m_minX.push_back(0.0f);
+            m_minY.push_back(0.0f);
+            m_minZ.push_back(0.0f);
+            m_maxX.push_back(0.0f);
+            m_maxY.push_back(0.0f);
+            m_maxZ.push_back(0.0f);
+        }
+
+        m_minX[slot] = min.x;
+        m_minY[slot] = min.y;
+        m_minZ[slot] = min.z;
+        m_maxX[slot] = max.x;
+        m_maxY[slot] = max.y;
+        m_maxZ[slot] = max.z;
+    }
+
+    void ChunkCuller::remove(VoxelChunk* chunk) {
+        int slot = chunk->getCullSlot();
+        if (slot < 0) return;
+
+        // Fill the hole with the last box
+        size_t last = m_chunks.size() - 1;
+        m_chunks[slot] = m_chunks[last];
+        m_minX[slot] = m_minX[last];
+        m_minY[slot] = m_minY[last];
+        m_minZ[slot] = m_minZ[last];
+        m_maxX[slot] = m_maxX[last];
+        m_maxY[slot] = m_maxY[last];
+        m_maxZ[slot] = m_maxZ[last];
+        m_chunks[slot]->setCullSlot(slot);
+
+        m_chunks.pop_back();
+        m_minX.pop_back();
+        m_minY.pop_back();
+        m_minZ.pop_back();
+        m_maxX.pop_back();
+        m_maxY.pop_back();
+        m_maxZ.pop_back();
+        chunk->setCullSlot(-1);
+    }
+
+    void ChunkCuller::clear() {
+        for (VoxelChunk* chunk : m_chunks) {
+            chunk->setCullSlot(-1);
+        }
+
+        m_chunks.clear();
+        m_minX.clear();
+        m_minY.clear();
+        m_minZ.clear();
+        m_maxX.clear();
+        m_maxY.clear();
+        m_maxZ.clear();
+    }
+
+    void ChunkCuller::cull(const renderer::Frustum& frustum, std::vector<VoxelChunk*>& visible) const {
+        // A box is outside once its corner furthest along a plane normal is behind that
+        // plane. Which corner that is only depends on the plane, so pick its arrays up front.
+        CullPlane planes[6];
+        for (int i = 0; i < 6; i++) {
+            const glm::vec4& plane = frustum.planes[i];
+            planes[i].nx = plane.x;
+            planes[i].ny = plane.y;
+            planes[i].nz = plane.z;
+            planes[i].d = plane.w;
+            planes[i].x = plane.x > 0.0f ? m_maxX.data() : m_minX.data();
+            planes[i].y = plane.y > 0.0f ? m_maxY.data() : m_minY.data();
+            planes[i].z = plane.z > 0.0f ? m_maxZ.data() : m_minZ.data();
+        }
+
+        size_t count = m_chunks.size();
+        size_t index = 0;
+
+#ifdef CHUNK_CULLER_SSE
+        const __m128 zero = _mm_setzero_ps();
+        for (; index + 4 <= count; index += 4) {
+            __m128 outside = zero;
+            for (const CullPlane& plane : planes) {
+                __m128 distance = _mm_add_ps(
+                    _mm_add_ps(
+                        _mm_mul_ps(_mm_set1_ps(plane.nx), _mm_loadu_ps(plane.x + index)),
+                        _mm_mul_ps(_mm_set1_ps(plane.ny), _mm_loadu_ps(plane.y + index))),
+                    _mm_add_ps(
+                        _mm_mul_ps(_mm_set1_ps(plane.nz), _mm_loadu_ps(plane.z + index)),
+                        _mm_set1_ps(plane.d)));
+                outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, zero));
+                // All four boxes are out already
+                if (_mm_movemask_ps(outside) == 0xF) break;
+            }
+
+            unsigned int inside = ~_mm_movemask_ps(outside) & 0xFu;
+            while (inside) {
+                visible.push_back(m_chunks[index + std::countr_zero(inside)]);
+                inside &= inside - 1;
+            }
+        }
+#endif
+
+        // Scalar tail, or everything without SSE
+        for (; index < count; index++) {
+            bool inside = true;
+            for (const CullPlane& plane : planes) {
+                float distance = plane.nx * plane.x[index] + plane.ny * plane.y[index] +
+                    plane.nz * plane.z[index] + plane.d;
+                if (distance < 0.0f) {
+                    inside = false;
+                    break;
+                }
+            }
+
+            if (inside) {
+                visible.push_back(m_chunks[index]);
+            }
+        }
+    }
+
+    size_t ChunkCuller::getCount() const {
+        return m_chunks.size();
+    }
+
+} // namespace voxel
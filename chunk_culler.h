@@ -0,0 +1,33 @@
+#pragma once
+
+#include "camera.h"
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace voxel {
+
+    class VoxelChunk;
+
+    // World-space boxes of the chunks that have something to draw, kept as parallel
+    // arrays (one per box coordinate) so the frustum test runs four boxes per SSE
+    // instruction. Each chunk remembers its slot (VoxelChunk::getCullSlot); removal
+    // moves the last box into the hole.
+    class ChunkCuller {
+    public:
+        // Adds the chunk or updates its box
+        void setBox(VoxelChunk* chunk, const glm::vec3& min, const glm::vec3& max);
+        void remove(VoxelChunk* chunk);
+        void clear();
+
+        // Appends the chunks whose boxes intersect the frustum to visible
+        void cull(const renderer::Frustum& frustum, std::vector<VoxelChunk*>& visible) const;
+
+        size_t getCount() const;
+
+    private:
+        std::vector<float> m_minX, m_minY, m_minZ;
+        std::vector<float> m_maxX, m_maxY, m_maxZ;
+        std::vector<VoxelChunk*> m_chunks;
+    };
+
+} // namespace voxel
@@ -0,0 +1,121 @@
+#include "chunk_geometry_arena.h"
+#include "mesh.h"
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <iostream>
+
+namespace renderer {
+
+    namespace {
+        // Four vertices of two 32-bit words per quad
+        const size_t QUAD_BYTES = 8 * sizeof(unsigned int);
+    }
+
+    ChunkGeometryArena::ChunkGeometryArena() {
+    }
+
+    ChunkGeometryArena::~ChunkGeometryArena() {
+        clear();
+    }
+
+    bool ChunkGeometryArena::allocate(unsigned int quadCount, GeometryRange& range) {
+        if (quadCount == 0) return false;
+
+        for (size_t page = 0; page < m_pages.size(); page++) {
+            unsigned int firstQuad;
+            if (m_pages[page].ranges.allocate(quadCount, firstQuad)) {
+                range.page = static_cast<int>(page);
+                range.firstQuad = firstQuad;
+                range.quadCount = quadCount;
+                return true;
+            }
+        }
+
+        int page = addPage(std::max(quadCount, PAGE_QUADS));
+        if (page < 0) return false;
+
+        m_pages[page].ranges.allocate(quadCount, range.firstQuad);
+        range.page = page;
+        range.quadCount = quadCount;
+        return true;
+    }
+
+    void ChunkGeometryArena::release(GeometryRange& range) {
+        if (!range.isValid()) return;
+
+        if (range.page < static_cast<int>(m_pages.size())) {
+            m_pages[range.page].ranges.release(range.firstQuad, range.quadCount);
+        }
+        range = GeometryRange();
+    }
+
+    void ChunkGeometryArena::upload(const GeometryRange& range, unsigned int firstQuad,
+        const unsigned int* vertices, size_t count) {
+        if (!range.isValid() || count == 0 || firstQuad + count / 8 > range.quadCount) return;
+
+        glBindBuffer(GL_ARRAY_BUFFER, m_pages[range.page].vbo);
+        glBufferSubData(GL_ARRAY_BUFFER, (range.firstQuad + firstQuad) * QUAD_BYTES,
+            count * sizeof(unsigned int), vertices);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    void ChunkGeometryArena::clear() {
+        for (Page& page : m_pages) {
+            glDeleteVertexArrays(1, &page.vao);
+            glDeleteBuffers(1, &page.vbo);
+        }
+        m_pages.clear();
+    }
+
+    int ChunkGeometryArena::getPageCount() const {
+        return static_cast<int>(m_pages.size());
+    }
+
+    unsigned int ChunkGeometryArena::getVertexArray(int page) const {
+        return m_pages[page].vao;
+    }
+
+    size_t ChunkGeometryArena::getUsedQuads() const {
+        size_t used = 0;
+        for (const Page& page : m_pages) {
+            used += page.ranges.getUsed();
+        }
+        return used;
+    }
+
+    int ChunkGeometryArena::addPage(unsigned int quadCount) {
+        Page page;
+        page.ranges.reset(quadCount);
+        glGenVertexArrays(1, &page.vao);
+        glGenBuffers(1, &page.vbo);
+
+        glBindVertexArray(page.vao);
+        glBindBuffer(GL_ARRAY_BUFFER, page.vbo);
+        glBufferData(GL_ARRAY_BUFFER, quadCount * QUAD_BYTES, nullptr, GL_DYNAMIC_DRAW);
+
+        // Packed voxel vertices, two integer words each, read by the voxel shader.
+        // Indices come from the shared quad index buffer.
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, Mesh::getQuadIndexBuffer());
+
+        glVertexAttribIPointer(0, 1, GL_UNSIGNED_INT, 2 * sizeof(unsigned int), (void*)0);
+        glEnableVertexAttribArray(0);
+
+        glVertexAttribIPointer(1, 1, GL_UNSIGNED_INT, 2 * sizeof(unsigned int), (void*)(sizeof(unsigned int)));
+        glEnableVertexAttribArray(1);
+
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        if (glGetError() == GL_OUT_OF_MEMORY) {
+            std::cerr << "Out of video memory for chunk geometry" << std::endl;
+            glDeleteVertexArrays(1, &page.vao);
+            glDeleteBuffers(1, &page.vbo);
+            return -1;
+        }
+
+        m_pages.push_back(page);
+        return static_cast<int>(m_pages.size()) - 1;
+    }
+
+} // namespace renderer
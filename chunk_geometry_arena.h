@@ -0,0 +1,73 @@
+#pragma once
+
+#include "range_allocator.h"
+#include <cstddef>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace renderer {
+
+    // Place of one chunk mesh inside a ChunkGeometryArena, in quads
+    struct GeometryRange {
+        int page = -1;
+        unsigned int firstQuad = 0;
+        unsigned int quadCount = 0;
+
+        bool isValid() const {
+            return page >= 0;
+        }
+    };
+
+    // One chunk to draw: all quads of its range, moved to origin by the voxel shader
+    struct ChunkDraw {
+        GeometryRange range;
+        glm::vec3 origin;
+        // World-space middle of the mesh, orders chunks front to back
+        glm::vec3 center;
+    };
+
+    // Shared vertex storage for chunk meshes. Quads in the packed voxel format live in a
+    // few large vertex buffers (pages), each with its own vertex array, and every chunk
+    // mesh is a sub-range of one page. Rendering binds a page once and draws all of its
+    // chunks together (see Renderer::drawChunks). Pages are created on first use and need
+    // the GL context.
+    class ChunkGeometryArena {
+    public:
+        // Quads per page (8 MB); larger meshes get a page of their own
+        static constexpr unsigned int PAGE_QUADS = 1u << 18;
+
+        ChunkGeometryArena();
+        ~ChunkGeometryArena();
+
+        ChunkGeometryArena(const ChunkGeometryArena&) = delete;
+        ChunkGeometryArena& operator=(const ChunkGeometryArena&) = delete;
+
+        bool allocate(unsigned int quadCount, GeometryRange& range);
+        void release(GeometryRange& range);
+
+        // Writes count vertex words (eight per quad) starting firstQuad quads into the range
+        void upload(const GeometryRange& range, unsigned int firstQuad, const unsigned int* vertices, size_t count);
+
+        // Deletes every page; ranges handed out become invalid
+        void clear();
+
+        int getPageCount() const;
+        // Vertex array of a page: packed vertex words on attributes 0 and 1, the shared
+        // quad index buffer bound. Attribute 2 (chunk origin) is left to the renderer.
+        unsigned int getVertexArray(int page) const;
+        // Quads allocated across all pages
+        size_t getUsedQuads() const;
+
+    private:
+        struct Page {
+            unsigned int vao;
+            unsigned int vbo;
+            RangeAllocator ranges;
+        };
+
+        int addPage(unsigned int quadCount);
+
+        std::vector<Page> m_pages;
+    };
+
+} // namespace renderer
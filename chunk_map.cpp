@@ -0,0 +1,137 @@
+#include "chunk_map.h"
+
+namespace voxel {
+
+    ChunkMap::ChunkMap()
+        : m_mask(0)
+    {
+    }
+
+    uint64_t ChunkMap::packKey(int chunkX, int chunkY, int chunkZ) {
+        // Bias each axis into 21 unsigned bits
+        const uint64_t bias = 1u << 20;
+        const uint64_t mask = (1u << 21) - 1;
+
+        return ((static_cast<uint64_t>(chunkX) + bias) & mask) |
+            (((static_cast<uint64_t>(chunkY) + bias) & mask) << 21) |
+            (((static_cast<uint64_t>(chunkZ) + bias) & mask) << 42);
+    }
+
+    VoxelChunk* ChunkMap::find(int chunkX, int chunkY, int chunkZ) const {
+        if (m_chunks.empty()) return nullptr;
+
+        size_t slot = findSlot(packKey(chunkX, chunkY, chunkZ));
+        if (m_slots[slot].key == EMPTY_KEY) return nullptr;
+
+        return m_chunks[m_slots[slot].index];
+    }
+
+    bool ChunkMap::insert(int chunkX, int chunkY, int chunkZ, VoxelChunk* chunk) {
+        // Keep the load factor at or below one half so probe chains stay short
+        if ((m_chunks.size() + 1) * 2 > m_slots.size()) {
+            grow();
+        }
+
+        uint64_t key = packKey(chunkX, chunkY, chunkZ);
+        size_t slot = findSlot(key);
+        if (m_slots[slot].key != EMPTY_KEY) return false;
+
+        m_slots[slot].key = key;
+        m_slots[slot].index = static_cast<uint32_t>(m_chunks.size());
+        m_chunks.push_back(chunk);
+        m_keys.push_back(key);
+        return true;
+    }
+
+    VoxelChunk* ChunkMap::erase(int chunkX, int chunkY, int chunkZ) {
+        if (m_chunks.empty()) return nullptr;
+
+        size_t slot = findSlot(packKey(chunkX, chunkY, chunkZ));
+        if (m_slots[slot].key == EMPTY_KEY) return nullptr;
+
+        // Move the last chunk into the gap in the dense array
+        uint32_t index = m_slots[slot].index;
+        VoxelChunk* chunk = m_chunks[index];
+        if (index != m_chunks.size() - 1) {
+            m_chunks[index] = m_chunks.back();
+            m_keys[index] = m_keys.back();
+            m_slots[findSlot(m_keys[index])].index = index;
+        }
+        m_chunks.pop_back();
+        m_keys.pop_back();
+
+        // Backward shift deletion: pull later entries of the probe chain into the hole
+        size_t hole = slot;
+        size_t next = (hole + 1) & m_mask;
+        while (m_slots[next].key != EMPTY_KEY) {
+            size_t home = hashKey(m_slots[next].key) & m_mask;
+
+            // Entries whose home lies cyclically in (hole, next] must stay put
+            if (((next - home) & m_mask) >= ((next - hole) & m_mask)) {
+                m_slots[hole] = m_slots[next];
+                hole = next;
+            }
+            next = (next + 1) & m_mask;
+        }
+        m_slots[hole].key = EMPTY_KEY;
+
+        return chunk;
+    }
+
+    void ChunkMap::clear() {
+        for (auto& slot : m_slots) {
+            slot.key = EMPTY_KEY;
+        }
+        m_chunks.clear();
+        m_keys.clear();
+    }
+
+    size_t ChunkMap::size() const {
+        return m_chunks.size();
+    }
+
+    bool ChunkMap::empty() const {
+        return m_chunks.empty();
+    }
+
+    VoxelChunk* const* ChunkMap::begin() const {
+        return m_chunks.data();
+    }
+
+    VoxelChunk* const* ChunkMap::end() const {
+        return m_chunks.data() + m_chunks.size();
+    }
+
+    uint64_t ChunkMap::hashKey(uint64_t key) {
+        // splitmix64 finalizer, neighbouring coordinates land far apart
+        key ^= key >> 30;
+        key *= 0xbf58476d1ce4e5b9ull;
+        key ^= key >> 27;
+        key *= 0x94d049bb133111ebull;
+        key ^= key >> 31;
+        return key;
+    }
+
+    size_t ChunkMap::findSlot(uint64_t key) const {
+        // Returns the slot holding key, or the empty slot where it would go
+        size_t slot = hashKey(key) & m_mask;
+        while (m_slots[slot].key != key && m_slots[slot].key != EMPTY_KEY) {
+            slot = (slot + 1) & m_mask;
+        }
+        return slot;
+    }
+
+    void ChunkMap::grow() {
+        size_t capacity = m_slots.empty() ? 64 : m_slots.size() * 2;
+        m_slots.assign(capacity, Slot{ EMPTY_KEY, 0 });
+        m_mask = capacity - 1;
+
+        // Reinsert from the dense array, indices are unchanged
+        for (uint32_t index = 0; index < m_keys.size(); index++) {
+            size_t slot = findSlot(m_keys[index]);
+            m_slots[slot].key = m_keys[index];
+            m_slots[slot].index = index;
+        }
+    }
+
+} // namespace voxel
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace voxel {
+
+    class VoxelChunk;
+
+    // Flat open-addressing hash table from chunk coordinates to chunks.
+    // Coordinates are packed into one 64-bit key (21 bits per axis) and probed
+    // linearly; the chunks themselves sit in a dense array for iteration.
+    class ChunkMap {
+    public:
+        ChunkMap();
+
+        // Chunk coordinates must lie within +-2^20
+        static uint64_t packKey(int chunkX, int chunkY, int chunkZ);
+
+        VoxelChunk* find(int chunkX, int chunkY, int chunkZ) const;
+        // Returns false if a chunk is already stored at these coordinates
+        bool insert(int chunkX, int chunkY, int chunkZ, VoxelChunk* chunk);
+        // Returns the removed chunk (not deleted) or nullptr
+        VoxelChunk* erase(int chunkX, int chunkY, int chunkZ);
+        void clear();
+
+        size_t size() const;
+        bool empty() const;
+
+        // Dense iteration over the stored chunks; erase moves the last chunk into the gap
+        VoxelChunk* const* begin() const;
+        VoxelChunk* const* end() const;
+
+    private:
+        struct Slot {
+            uint64_t key;
+            uint32_t index;
+        };
+
+        static const uint64_t EMPTY_KEY = ~uint64_t(0);
+
+        static uint64_t hashKey(uint64_t key);
+        size_t findSlot(uint64_t key) const;
+        void grow();
+
+        std::vector<Slot> m_slots;
+        std::vector<VoxelChunk*> m_chunks;
+        std::vector<uint64_t> m_keys;
+        size_t m_mask;
+    };
+
+} // namespace voxel
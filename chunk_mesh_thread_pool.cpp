@@ -0,0 +1,148 @@
+#include "chunk_mesh_thread_pool.h"
+#include "linear_arena.h"
+#include <algorithm>
+#include <iostream>
+
+namespace voxel {
+
+    ChunkMeshThreadPool::ChunkMeshThreadPool()
+        : m_stopping(false)
+        , m_pendingCount(0)
+    {
+    }
+
+    ChunkMeshThreadPool::~ChunkMeshThreadPool() {
+        shutdown();
+    }
+
+    bool ChunkMeshThreadPool::initialize(int threadCount) {
+        if (!m_threads.empty()) return true;
+
+        if (threadCount <= 0) {
+            int hardwareThreads = static_cast<int>(std::thread::hardware_concurrency());
+            threadCount = std::max(1, hardwareThreads - 1);
+        }
+
+        m_stopping = false;
+        for (int i = 0; i < threadCount; i++) {
+            m_threads.emplace_back(&ChunkMeshThreadPool::workerLoop, this);
+        }
+
+        std::cout << "Chunk meshing running on " << threadCount << " worker threads" << std::endl;
+        return true;
+    }
+
+    void ChunkMeshThreadPool::shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(m_jobMutex);
+            m_stopping = true;
+            m_jobs.clear();
+        }
+        m_jobAvailable.notify_all();
+
+        for (auto& thread : m_threads) {
+            thread.join();
+        }
+        m_threads.clear();
+
+        {
+            std::lock_guard<std::mutex> lock(m_resultMutex);
+            m_results.clear();
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_recycleMutex);
+            m_freeInputs.clear();
+            m_freeOutputs.clear();
+        }
+        m_pendingCount = 0;
+    }
+
+    void ChunkMeshThreadPool::acquireJob(ChunkMeshJob& job) {
+        std::lock_guard<std::mutex> lock(m_recycleMutex);
+        if (m_freeInputs.empty()) return;
+
+        job.input = std::move(m_freeInputs.back());
+        m_freeInputs.pop_back();
+    }
+
+    void ChunkMeshThreadPool::submit(ChunkMeshJob&& job) {
+        m_pendingCount++;
+        {
+            std::lock_guard<std::mutex> lock(m_jobMutex);
+            m_jobs.push(std::move(job));
+        }
+        m_jobAvailable.notify_one();
+    }
+
+    bool ChunkMeshThreadPool::popResult(ChunkMeshResult& result) {
+        std::lock_guard<std::mutex> lock(m_resultMutex);
+        if (m_results.empty()) return false;
+
+        m_results.pop(result);
+        m_pendingCount--;
+        return true;
+    }
+
+    void ChunkMeshThreadPool::recycleInput(ChunkMeshInput&& input) {
+        std::lock_guard<std::mutex> lock(m_recycleMutex);
+        if (m_freeInputs.size() < MAX_RECYCLED) {
+            m_freeInputs.push_back(std::move(input));
+        }
+    }
+
+    void ChunkMeshThreadPool::recycleOutput(ChunkMeshOutput&& output) {
+        std::lock_guard<std::mutex> lock(m_recycleMutex);
+        if (m_freeOutputs.size() < MAX_RECYCLED) {
+            m_freeOutputs.push_back(std::move(output));
+        }
+    }
+
+    int ChunkMeshThreadPool::getPendingCount() const {
+        return m_pendingCount;
+    }
+
+    int ChunkMeshThreadPool::getThreadCount() const {
+        return static_cast<int>(m_threads.size());
+    }
+
+    void ChunkMeshThreadPool::workerLoop() {
+        // Each worker keeps its own mesher so the face masks are reused between jobs
+        ChunkMesher mesher;
+        engine::LinearArena& arena = engine::getFrameArena();
+
+        while (true) {
+            ChunkMeshJob job;
+            {
+                std::unique_lock<std::mutex> lock(m_jobMutex);
+                m_jobAvailable.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+                if (m_stopping) return;
+
+                m_jobs.pop(job);
+            }
+
+            // Scratch from the previous job is dead by now
+            arena.reset();
+
+            ChunkMeshResult result;
+            result.chunkX = job.chunkX;
+            result.chunkY = job.chunkY;
+            result.chunkZ = job.chunkZ;
+            result.revision = job.revision;
+            {
+                std::lock_guard<std::mutex> lock(m_recycleMutex);
+                if (!m_freeOutputs.empty()) {
+                    result.output = std::move(m_freeOutputs.back());
+                    m_freeOutputs.pop_back();
+                }
+            }
+
+            mesher.build(job.input, result.output);
+
+            recycleInput(std::move(job.input));
+
+            std::lock_guard<std::mutex> lock(m_resultMutex);
+            m_results.push(std::move(result));
+        }
+    }
+
+} // namespace voxel
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "chunk_mesher.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace voxel {
+
+    // Snapshot of one chunk waiting to be meshed
+    struct ChunkMeshJob {
+        int chunkX = 0;
+        int chunkY = 0;
+        int chunkZ = 0;
+        unsigned int revision = 0;
+        ChunkMeshInput input;
+    };
+
+    // Finished CPU vertex data, uploaded on the main thread
+    struct ChunkMeshResult {
+        int chunkX = 0;
+        int chunkY = 0;
+        int chunkZ = 0;
+        unsigned int revision = 0;
+        ChunkMeshOutput output;
+    };
+
+    // First in, first out queue over a vector that keeps its capacity. Popped slots are
+    // only reclaimed once the queue drains or the front half is used up, so unlike a
+    // deque it stops allocating once it has grown to the largest backlog seen.
+    template <typename T>
+    class ReusableQueue {
+    public:
+        bool empty() const { return m_head == m_items.size(); }
+        size_t size() const { return m_items.size() - m_head; }
+
+        void push(T&& item) {
+            if (m_head > 0 && m_head * 2 >= m_items.size()) {
+                m_items.erase(m_items.begin(), m_items.begin() + m_head);
+                m_head = 0;
+            }
+            m_items.push_back(std::move(item));
+        }
+
+        void pop(T& item) {
+            item = std::move(m_items[m_head++]);
+            if (m_head == m_items.size()) {
+                clear();
+            }
+        }
+
+        void clear() {
+            m_items.clear();
+            m_head = 0;
+        }
+
+    private:
+        std::vector<T> m_items;
+        size_t m_head = 0;
+    };
+
+    // Meshes chunk snapshots on worker threads. Jobs go in through submit(),
+    // finished meshes come back through popResult() on the main thread.
+    //
+    // Job inputs and result outputs are recycled once they are done with, so after
+    // warming up the snapshot and vertex vectors keep their capacity instead of being
+    // allocated for every job. The job and result queues keep their capacity the same way.
+    class ChunkMeshThreadPool {
+    public:
+        ChunkMeshThreadPool();
+        ~ChunkMeshThreadPool();
+
+        // threadCount <= 0 picks one less than the hardware thread count
+        bool initialize(int threadCount = 0);
+        void shutdown();
+
+        // Gives job the input buffers of an earlier job, if one is spare
+        void acquireJob(ChunkMeshJob& job);
+        void submit(ChunkMeshJob&& job);
+        bool popResult(ChunkMeshResult& result);
+        // Returns job input buffers once their snapshot is no longer needed
+        void recycleInput(ChunkMeshInput&& input);
+        // Returns the output of a popped result once it has been uploaded
+        void recycleOutput(ChunkMeshOutput&& output);
+
+        // Jobs submitted whose results have not been popped yet
+        int getPendingCount() const;
+        int getThreadCount() const;
+
+    private:
+        void workerLoop();
+
+        std::vector<std::thread> m_threads;
+
+        std::mutex m_jobMutex;
+        std::condition_variable m_jobAvailable;
+        ReusableQueue<ChunkMeshJob> m_jobs;
+        bool m_stopping;
+
+        std::mutex m_resultMutex;
+        ReusableQueue<ChunkMeshResult> m_results;
+
+        // Spare buffers, capped so a burst of jobs does not pin its memory forever
+        static const size_t MAX_RECYCLED = 64;
+        std::mutex m_recycleMutex;
+        std::vector<ChunkMeshInput> m_freeInputs;
+        std::vector<ChunkMeshOutput> m_freeOutputs;
+
+        std::atomic<int> m_pendingCount;
+    };
+
+} // namespace voxel
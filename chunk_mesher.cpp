@@ -0,0 +1,318 @@
+#include "chunk_mesher.h"
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <bit>
+
+namespace voxel {
+
+    namespace {
+
+        // Mask of the lowest count bits
+        RowMask lowBits(int count) {
+            return (count >= 64) ? ~RowMask(0) : ((RowMask(1) << count) - 1);
+        }
+
+        // Transposes the set bits of an X-row into the X-normal planes (planes[x * SIZE_Y + y], bit z)
+        void scatterColumns(RowMask bits, std::vector<RowMask>& plane, int y, int z) {
+            while (bits) {
+                int x = std::countr_zero(bits);
+                plane[x * WorldChunkShape::SIZE_Y + y] |= RowMask(1) << z;
+                bits &= bits - 1;
+            }
+        }
+
+    } // namespace
+
+    ChunkMesher::ChunkMesher()
+        : m_singleMaterial(DEFAULT_MATERIAL)
+        , m_materials(nullptr)
+    {
+    }
+
+    ChunkMesher::~ChunkMesher() {
+    }
+
+    void ChunkMesher::build(const ChunkMeshInput& input, ChunkMeshOutput& output) {
+        extractFaces(input);
+
+        output.sections = input.sections;
+        output.sectionVertices.resize(SECTION_COUNT);
+        output.boundsMin = input.boundsMin;
+        output.boundsMax = input.boundsMax;
+
+        for (int section = 0; section < SECTION_COUNT; section++) {
+            if (!(input.sections & (1u << section))) continue;
+
+            std::vector<unsigned int>& vertices = output.sectionVertices[section];
+            vertices.clear();
+
+            int yBegin = section * SECTION_HEIGHT;
+            int yEnd = yBegin + SECTION_HEIGHT;
+
+            if (input.mode == MeshingMode::GREEDY) {
+                emitGreedy(vertices, yBegin, yEnd);
+            }
+            else {
+                emitNaive(vertices, yBegin, yEnd);
+            }
+        }
+    }
+
+    void ChunkMesher::extractFaces(const ChunkMeshInput& input) {
+        const RowMask* rows = input.rows.data();
+        const RowMask* opaque = input.opaqueRows.empty() ? rows : input.opaqueRows.data();
+
+        m_singleMaterial = input.singleMaterial;
+        m_materials = input.materials.empty() ? nullptr : input.materials.data();
+
+        // Neighbour boundary slices, empty (all faces exposed) when not loaded
+        const RowMask* neighbors[6];
+        for (int face = 0; face < 6; face++) {
+            neighbors[face] = input.neighbors[face].empty() ? nullptr : input.neighbors[face].data();
+        }
+
+        for (int face = 0; face < 6; face++) {
+            m_faces.planes[face].assign(Shape::getSize(FACE_AXIS[face]) * getPlaneRows(face), 0);
+        }
+
+        for (int z = 0; z < Shape::SIZE_Z; z++) {
+            for (int y = 0; y < Shape::SIZE_Y; y++) {
+                int index = Shape::getRowIndex(y, z);
+                RowMask row = rows[index];
+                if (!row) continue;
+
+                // Neighbouring opaque rows, taken from the neighbour slices on the chunk border
+                RowMask front = (z > 0) ? opaque[index - Shape::SIZE_Y] : (neighbors[0] ? neighbors[0][y] : 0);
+                RowMask back = (z + 1 < Shape::SIZE_Z) ? opaque[index + Shape::SIZE_Y] : (neighbors[1] ? neighbors[1][y] : 0);
+                RowMask below = (y > 0) ? opaque[index - 1] : (neighbors[4] ? neighbors[4][z] : 0);
+                RowMask above = (y + 1 < Shape::SIZE_Y) ? opaque[index + 1] : (neighbors[5] ? neighbors[5][z] : 0);
+
+                // Row shifted by one voxel with the neighbour's edge voxel shifted in
+                RowMask opaqueRow = opaque[index];
+                RowMask leftEdge = neighbors[2] ? ((neighbors[2][y] >> z) & 1) : 0;
+                RowMask rightEdge = neighbors[3] ? ((neighbors[3][y] >> z) & 1) : 0;
+                RowMask left = (opaqueRow << 1) | leftEdge;
+                RowMask right = (opaqueRow >> 1) | (rightEdge << (Shape::SIZE_X - 1));
+
+                // Faces in row layout (bit x), in face order
+                RowMask faces[6] = {
+                    row & ~front, row & ~back, row & ~left, row & ~right, row & ~below, row & ~above
+                };
+
+                // Transparent voxels also hide faces against the same material
+                RowMask transparentRow = row & ~opaqueRow;
+                if (transparentRow) {
+                    cullTransparentFaces(input, faces, transparentRow, y, z);
+                }
+
+                // Z and Y faces keep the row's X bits as the plane's u axis
+                m_faces.planes[0][index] = faces[0];
+                m_faces.planes[1][index] = faces[1];
+                m_faces.planes[4][y * Shape::SIZE_Z + z] = faces[4];
+                m_faces.planes[5][y * Shape::SIZE_Z + z] = faces[5];
+
+                // X faces are transposed into their planes
+                scatterColumns(faces[2], m_faces.planes[2], y, z);
+                scatterColumns(faces[3], m_faces.planes[3], y, z);
+            }
+        }
+    }
+
+    void ChunkMesher::cullTransparentFaces(const ChunkMeshInput& input, RowMask faces[6],
+        RowMask transparentRow, int y, int z) const {
+        static const int offsets[6][3] = {
+            { 0, 0, -1 }, { 0, 0, 1 }, { -1, 0, 0 }, { 1, 0, 0 }, { 0, -1, 0 }, { 0, 1, 0 }
+        };
+
+        const RowMask* rows = input.rows.data();
+
+        for (int face = 0; face < 6; face++) {
+            RowMask bits = faces[face] & transparentRow;
+
+            while (bits) {
+                int x = std::countr_zero(bits);
+                bits &= bits - 1;
+
+                int nx = x + offsets[face][0];
+                int ny = y + offsets[face][1];
+                int nz = z + offsets[face][2];
+                MaterialId neighbor = AIR_MATERIAL;
+
+                if (Shape::contains(nx, ny, nz)) {
+                    if ((rows[Shape::getRowIndex(ny, nz)] >> nx) & 1) {
+                        neighbor = m_materials ? m_materials[Shape::getVoxelIndex(nx, ny, nz)] : m_singleMaterial;
+                    }
+                }
+                else if (!input.neighborMaterials[face].empty()) {
+                    // Boundary slices are in plane layout (v * sizeU + u)
+                    int index = FACE_AXIS[face] == 2 ? y * Shape::SIZE_X + x :
+                        FACE_AXIS[face] == 0 ? y * Shape::SIZE_Z + z : z * Shape::SIZE_X + x;
+                    neighbor = input.neighborMaterials[face][index];
+                }
+
+                MaterialId material = m_materials ? m_materials[Shape::getVoxelIndex(x, y, z)] : m_singleMaterial;
+                if (neighbor == material) {
+                    faces[face] &= ~(RowMask(1) << x);
+                }
+            }
+        }
+    }
+
+    const ChunkFaceMasks& ChunkMesher::getFaceMasks() const {
+        return m_faces;
+    }
+
+    ChunkMesher::PlaneRange ChunkMesher::getPlaneRange(int face, int yBegin, int yEnd) const {
+        PlaneRange range = { 0, Shape::getSize(FACE_AXIS[face]), 0, getPlaneRows(face),
+            lowBits(getPlaneWidth(face)) };
+
+        // Y runs along the normal or the v rows, never along u
+        if (FACE_AXIS[face] == 1) {
+            range.sliceBegin = yBegin;
+            range.sliceEnd = yEnd;
+        }
+        else {
+            range.vBegin = yBegin;
+            range.vEnd = yEnd;
+        }
+
+        return range;
+    }
+
+    void ChunkMesher::emitNaive(std::vector<unsigned int>& vertices, int yBegin, int yEnd) const {
+        for (int face = 0; face < 6; face++) {
+            const std::vector<RowMask>& plane = m_faces.planes[face];
+            PlaneRange range = getPlaneRange(face, yBegin, yEnd);
+            int rows = getPlaneRows(face);
+
+            for (int slice = range.sliceBegin; slice < range.sliceEnd; slice++) {
+                for (int v = range.vBegin; v < range.vEnd; v++) {
+                    RowMask bits = plane[slice * rows + v] & range.uMask;
+                    while (bits) {
+                        int u = std::countr_zero(bits);
+                        emitFace(vertices, face, slice, u, v, 1, 1, getPlaneMaterial(face, slice, u, v));
+                        bits &= bits - 1;
+                    }
+                }
+            }
+        }
+    }
+
+    void ChunkMesher::emitGreedy(std::vector<unsigned int>& vertices, int yBegin, int yEnd) {
+        // Consumes the face masks while merging, runs never leave the section
+        for (int face = 0; face < 6; face++) {
+            PlaneRange range = getPlaneRange(face, yBegin, yEnd);
+            int rows = getPlaneRows(face);
+
+            for (int slice = range.sliceBegin; slice < range.sliceEnd; slice++) {
+                RowMask* plane = &m_faces.planes[face][slice * rows];
+
+                for (int v = range.vBegin; v < range.vEnd; v++) {
+                    while (plane[v] & range.uMask) {
+                        // Longest run of exposed faces along u
+                        RowMask bits = plane[v] & range.uMask;
+                        int u = std::countr_zero(bits);
+                        int width = std::countr_one(bits >> u);
+                        MaterialId material = getPlaneMaterial(face, slice, u, v);
+
+                        // With mixed materials the run also has to keep one material
+                        if (m_materials) {
+                            int sameWidth = 1;
+                            while (sameWidth < width && getPlaneMaterial(face, slice, u + sameWidth, v) == material) {
+                                sameWidth++;
+                            }
+                            width = sameWidth;
+                        }
+
+                        RowMask run = lowBits(width) << u;
+                        plane[v] &= ~run;
+
+                        // Grow along v while the following rows contain the whole run
+                        int height = 1;
+                        while (v + height < range.vEnd && (plane[v + height] & run) == run &&
+                            isPlaneRunMaterial(face, slice, u, width, v + height, material)) {
+                            plane[v + height] &= ~run;
+                            height++;
+                        }
+
+                        emitFace(vertices, face, slice, u, v, width, height, material);
+                    }
+                }
+            }
+        }
+    }
+
+    MaterialId ChunkMesher::getPlaneMaterial(int face, int slice, int u, int v) const {
+        if (!m_materials) return m_singleMaterial;
+
+        int coords[3];
+        coords[FACE_AXIS[face]] = slice;
+        coords[FACE_U[face]] = u;
+        coords[FACE_V[face]] = v;
+
+        return m_materials[Shape::getVoxelIndex(coords[0], coords[1], coords[2])];
+    }
+
+    bool ChunkMesher::isPlaneRunMaterial(int face, int slice, int u, int width, int v, MaterialId material) const {
+        if (!m_materials) return true;
+
+        for (int i = 0; i < width; i++) {
+            if (getPlaneMaterial(face, slice, u + i, v) != material) return false;
+        }
+        return true;
+    }
+
+    void ChunkMesher::emitFace(std::vector<unsigned int>& vertices,
+        int face, int slice, int u, int v, int width, int height, MaterialId material) {
+        int origin[3];
+        int extent[3];
+        origin[FACE_AXIS[face]] = slice;
+        origin[FACE_U[face]] = u;
+        origin[FACE_V[face]] = v;
+        extent[FACE_AXIS[face]] = 1;
+        extent[FACE_U[face]] = width;
+        extent[FACE_V[face]] = height;
+
+        createCubeFace(vertices, origin[0], origin[1], origin[2], face,
+            extent[0], extent[1], extent[2], material);
+    }
+
+    unsigned int ChunkMesher::packVertex(int x, int y, int z, int faceIndex, int ambientOcclusion) {
+        return (unsigned int)x
+            | ((unsigned int)y << 9)
+            | ((unsigned int)z << 18)
+            | ((unsigned int)faceIndex << 27)
+            | ((unsigned int)ambientOcclusion << 30);
+    }
+
+    void ChunkMesher::createCubeFace(std::vector<unsigned int>& vertices,
+        int x, int y, int z, int faceIndex, int sizeX, int sizeY, int sizeZ, MaterialId material) {
+        // Define the 8 vertices of the box
+        glm::ivec3 v0(x, y, z);
+        glm::ivec3 v1(x + sizeX, y, z);
+        glm::ivec3 v2(x + sizeX, y + sizeY, z);
+        glm::ivec3 v3(x, y + sizeY, z);
+        glm::ivec3 v4(x, y, z + sizeZ);
+        glm::ivec3 v5(x + sizeX, y, z + sizeZ);
+        glm::ivec3 v6(x + sizeX, y + sizeY, z + sizeZ);
+        glm::ivec3 v7(x, y + sizeY, z + sizeZ);
+
+        // Corners of each face in winding order, the normal comes from the face index
+        const glm::ivec3* corners[6][4] = {
+            { &v0, &v1, &v2, &v3 }, // Front face (negative z)
+            { &v4, &v7, &v6, &v5 }, // Back face (positive z)
+            { &v0, &v3, &v7, &v4 }, // Left face (negative x)
+            { &v1, &v5, &v6, &v2 }, // Right face (positive x)
+            { &v0, &v4, &v5, &v1 }, // Bottom face (negative y)
+            { &v3, &v2, &v6, &v7 }  // Top face (positive y)
+        };
+
+        // Add vertices for the selected face.
+        // Triangles come from the shared quad index pattern (0, 1, 2, 0, 2, 3).
+        for (const glm::ivec3* corner : corners[faceIndex]) {
+            vertices.push_back(packVertex(corner->x, corner->y, corner->z, faceIndex, 0));
+            vertices.push_back(material);
+        }
+    }
+
+} // namespace voxel
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "voxel_system.h"
+#include <vector>
+
+namespace voxel {
+
+    // Exposed faces of a chunk, one bit plane per face direction.
+    // planes[face][slice * rows + v] holds bit u for the face at (slice, u, v), where
+    // slice runs along the face normal and rows is the chunk size along v (see
+    // ChunkMesher::FACE_AXIS). u is always X or Z, so a plane row fits one RowMask.
+    struct ChunkFaceMasks {
+        std::vector<RowMask> planes[6];
+    };
+
+    // Self-contained copy of everything needed to mesh one chunk, so meshing
+    // does not touch the live world. Only the sections set in the sections bit
+    // mask are meshed. The chunk has the extents of WorldChunkShape.
+    //
+    // rows holds the solid voxels and opaqueRows the opaque ones (empty when all
+    // solid voxels are opaque), indexed WorldChunkShape::getRowIndex(y, z).
+    // neighbors[face] is the opaque boundary slice of the adjacent chunk across that
+    // face in plane layout (row v, bit u), or empty when no chunk is loaded there.
+    // Materials come from singleMaterial when every solid voxel shares one, otherwise
+    // from materials (indexed WorldChunkShape::getVoxelIndex). neighborMaterials are
+    // boundary material slices (index v * sizeU + u), only needed when the chunk has
+    // transparent voxels. boundsMin/boundsMax are the inclusive local bounds of the
+    // solid voxels, min > max when there are none.
+    struct ChunkMeshInput {
+        MeshingMode mode = MeshingMode::GREEDY;
+        unsigned int sections = 0;
+        std::vector<RowMask> rows;
+        std::vector<RowMask> opaqueRows;
+        std::vector<RowMask> neighbors[6];
+        MaterialId singleMaterial = DEFAULT_MATERIAL;
+        std::vector<MaterialId> materials;
+        std::vector<MaterialId> neighborMaterials[6];
+        VoxelPos boundsMin = { 0, 0, 0 };
+        VoxelPos boundsMax = { -1, -1, -1 };
+    };
+
+    // Quad vertices per chunk section; only the entries in the sections mask are valid.
+    // The bounds are passed through from the input and enclose every quad of the chunk.
+    struct ChunkMeshOutput {
+        unsigned int sections = 0;
+        std::vector<std::vector<unsigned int>> sectionVertices;
+        VoxelPos boundsMin = { 0, 0, 0 };
+        VoxelPos boundsMax = { -1, -1, -1 };
+    };
+
+    // Chunk vertices are packed into VERTEX_WORDS 32-bit words and decoded by the "voxel" shader:
+    //   word 0: x (9 bits) | y (9) | z (9) | face index (3) | ambient occlusion (2)
+    //   word 1: material id (16) | reserved (16)
+    // Greedy meshing only merges faces of the same material.
+    // Positions are local to the chunk, the shader adds the chunk origin.
+    //
+    // Chunks are meshed in sections, slabs SECTION_HEIGHT voxels high, so a single
+    // edit only re-emits and re-uploads the slab it touched. Tall chunks use taller
+    // sections so the section masks fit 32 bits.
+    class ChunkMesher {
+    public:
+        typedef WorldChunkShape Shape;
+
+        static const int VERTEX_WORDS = 2;
+        static constexpr int SECTION_HEIGHT = Shape::SIZE_Y > 128 ? Shape::SIZE_Y / 32 : 4;
+        static constexpr int SECTION_COUNT = Shape::SIZE_Y / SECTION_HEIGHT;
+        static constexpr unsigned int ALL_SECTIONS =
+            SECTION_COUNT == 32 ? ~0u : (1u << SECTION_COUNT) - 1;
+
+        // Bit of the section holding voxel row y
+        static constexpr unsigned int getSection(int y) {
+            return 1u << (y / SECTION_HEIGHT);
+        }
+
+        ChunkMesher();
+        ~ChunkMesher();
+
+        // Builds quad vertex data for the requested sections of a chunk snapshot, four vertices
+        // per quad drawn with the renderer's shared quad index buffer
+        void build(const ChunkMeshInput& input, ChunkMeshOutput& output);
+
+        // Face extraction kernel: finds every exposed face with shift/AND-NOT over whole rows.
+        // Faces on the chunk border are culled against the neighbour slices. Faces of
+        // transparent voxels touching the same material are removed afterwards.
+        void extractFaces(const ChunkMeshInput& input);
+        const ChunkFaceMasks& getFaceMasks() const;
+
+        // Quad emitters fed by the extracted face masks, limited to voxels with y in [yBegin, yEnd)
+        void emitNaive(std::vector<unsigned int>& vertices, int yBegin, int yEnd) const;
+        void emitGreedy(std::vector<unsigned int>& vertices, int yBegin, int yEnd);
+
+        static unsigned int packVertex(int x, int y, int z, int faceIndex, int ambientOcclusion);
+
+        // Emits one face of the box spanning sizeX * sizeY * sizeZ voxels starting at (x, y, z)
+        static void createCubeFace(std::vector<unsigned int>& vertices,
+            int x, int y, int z, int faceIndex, int sizeX = 1, int sizeY = 1, int sizeZ = 1,
+            MaterialId material = DEFAULT_MATERIAL);
+
+        // Axis (0 = x, 1 = y, 2 = z) of the face normal and of the plane's u/v directions, in
+        // FaceDirection order
+        static constexpr int FACE_AXIS[6] = { 2, 2, 0, 0, 1, 1 };
+        static constexpr int FACE_U[6] = { 0, 0, 2, 2, 0, 0 };
+        static constexpr int FACE_V[6] = { 1, 1, 1, 1, 2, 2 };
+
+        // Rows per slice and bits per row of a face plane
+        static constexpr int getPlaneRows(int face) {
+            return Shape::getSize(FACE_V[face]);
+        }
+        static constexpr int getPlaneWidth(int face) {
+            return Shape::getSize(FACE_U[face]);
+        }
+
+    private:
+        // Part of a face's planes that belongs to the voxels with y in [yBegin, yEnd)
+        struct PlaneRange {
+            int sliceBegin, sliceEnd;
+            int vBegin, vEnd;
+            RowMask uMask;
+        };
+        PlaneRange getPlaneRange(int face, int yBegin, int yEnd) const;
+
+        // Removes faces between transparent voxels of one material from a row's faces
+        void cullTransparentFaces(const ChunkMeshInput& input, RowMask faces[6],
+            RowMask transparentRow, int y, int z) const;
+
+        // Material of the voxel owning the face at (slice, u, v) of a face plane
+        MaterialId getPlaneMaterial(int face, int slice, int u, int v) const;
+        // True if the faces [u, u + width) in row v all have the given material
+        bool isPlaneRunMaterial(int face, int slice, int u, int width, int v, MaterialId material) const;
+
+        static void emitFace(std::vector<unsigned int>& vertices,
+            int face, int slice, int u, int v, int width, int height, MaterialId material);
+
+        ChunkFaceMasks m_faces;
+
+        // Materials of the chunk being meshed, set by extractFaces
+        MaterialId m_singleMaterial;
+        const MaterialId* m_materials;
+    };
+
+} // namespace voxel
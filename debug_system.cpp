@@ -1,10 +1,12 @@
 #include "debug_system.h"
 #include "renderer.h"
 #include "camera.h"
+#include "voxel_system.h"
 #include <GLFW/glfw3.h>
 #include <imgui.h>
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_opengl3.h>
+#include <algorithm>
 #include <sstream>
 #include <iomanip>
 #include <cmath>
@@ -24,6 +26,7 @@ namespace debug {
         , m_windowWidth(800)
         , m_windowHeight(600)
         , m_camera(nullptr)
+        , m_voxelSystem(nullptr)
     {
     }
 
@@ -67,21 +70,20 @@ namespace debug {
         m_camera = camera;
     }
 
+    void DebugViewer::setVoxelSystem(voxel::VoxelSystem* voxelSystem) {
+        m_voxelSystem = voxelSystem;
+    }
+
     void DebugViewer::update(float deltaTime) {
         // Update performance metrics
         updatePerformanceMetrics(deltaTime);
 
-        // Update debug lines
-        for (auto it = m_lines.begin(); it != m_lines.end();) {
-            if (it->duration > 0.0f) {
-                it->timeRemaining -= deltaTime;
-                if (it->timeRemaining <= 0.0f) {
-                    it = m_lines.erase(it);
-                    continue;
-                }
-            }
-            ++it;
-        }
+        // Update debug lines, expired ones are dropped in a single pass
+        m_lines.erase(std::remove_if(m_lines.begin(), m_lines.end(), [deltaTime](DebugLine& line) {
+            if (line.duration <= 0.0f) return false;
+            line.timeRemaining -= deltaTime;
+            return line.timeRemaining <= 0.0f;
+        }), m_lines.end());
 
         // Update debug texts
         for (auto it = m_texts.begin(); it != m_texts.end();) {
@@ -104,14 +106,9 @@ namespace debug {
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
 
-        // Render debug lines
-        for (const auto& line : m_lines) {
-            std::vector<float> vertices = {
-                line.start.x, line.start.y, line.start.z,
-                line.end.x, line.end.y, line.end.z
-            };
-
-            renderer->drawLines(vertices, line.color);
+        // Render debug lines, the renderer batches all of them into one draw
+        for (const DebugLine& line : m_lines) {
+            renderer->drawLine(line.start, line.end, line.color);
         }
 
         // Render performance metrics with ImGui
@@ -119,6 +116,9 @@ namespace debug {
             renderPerformanceMetrics(renderer);
         }
 
+        // Draw the queued world and lines before ImGui goes on top
+        renderer->flush();
+
         // Render ImGui
         ImGui::Render();
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
@@ -261,6 +261,12 @@ namespace debug {
         ImGui::Text("Frame Time: %.2f ms", m_frameTime);
         ImGui::Text("CPU Time: %.2f ms", m_cpuTime);
 
+        // Queue and state cache counts of the previous frame
+        const renderer::RenderStats& renderStats = renderer->getStats();
+        ImGui::Text("Draw Calls: %d", renderStats.drawCalls);
+        ImGui::Text("Binds - Program: %d, Vertex Array: %d, Buffer: %d",
+            renderStats.programBinds, renderStats.vertexArrayBinds, renderStats.bufferBinds);
+
         // Add a graph for FPS history
         static float fpsValues[100] = {};
         static int fpsOffset = 0;
@@ -287,6 +293,25 @@ namespace debug {
                 m_camera->getPitch());
         }
 
+        // Add chunk remeshing info if available
+        if (m_voxelSystem) {
+            voxel::RemeshStats stats = m_voxelSystem->getRemeshStats();
+            ImGui::Separator();
+            ImGui::Text("Remesh: %.2f / %.2f ms", stats.usedMs, stats.budgetMs);
+            ImGui::Text("Remesh Backlog: %d, Workers: %d", stats.backlog, stats.pendingJobs);
+            ImGui::Text("Remeshed - Immediate: %d, Submitted: %d (%d skipped), Uploaded: %d",
+                stats.immediateChunks, stats.submittedChunks, stats.skippedChunks, stats.uploadedChunks);
+
+            voxel::CullStats cullStats = m_voxelSystem->getCullStats();
+            ImGui::Text("Chunks Drawn: %d, Culled: %d", cullStats.drawnChunks, cullStats.culledChunks);
+
+            voxel::VoxelPos min, max;
+            ImGui::Text("Voxels: %lld", static_cast<long long>(m_voxelSystem->getVoxelCount()));
+            if (m_voxelSystem->getBounds(min, max)) {
+                ImGui::Text("World Bounds: (%d, %d, %d) - (%d, %d, %d)", min.x, min.y, min.z, max.x, max.y, max.z);
+            }
+        }
+
         ImGui::End();
     }
 
@@ -311,6 +336,12 @@ namespace debug {
         }
     }
 
+    void DebugSystem::setVoxelSystem(voxel::VoxelSystem* voxelSystem) {
+        if (m_viewer) {
+            m_viewer->setVoxelSystem(voxelSystem);
+        }
+    }
+
     void DebugSystem::shutdown() {
         if (m_viewer) {
             m_viewer->shutdown();
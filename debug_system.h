@@ -11,6 +11,10 @@ namespace renderer {
     class Camera;  // Add Camera forward declaration
 }
 
+namespace voxel {
+    class VoxelSystem;
+}
+
 namespace debug {
 
     struct DebugLine {
@@ -43,6 +47,9 @@ namespace debug {
         // Set camera reference
         void setCamera(renderer::Camera* camera);
 
+        // Set voxel system reference for world statistics
+        void setVoxelSystem(voxel::VoxelSystem* voxelSystem);
+
         // Debug drawing functions
         void drawLine(const glm::vec3& start, const glm::vec3& end, const glm::vec3& color = glm::vec3(1.0f), float duration = 0.0f);
         void drawBox(const glm::vec3& min, const glm::vec3& max, const glm::vec3& color = glm::vec3(1.0f), float duration = 0.0f);
@@ -78,6 +85,9 @@ namespace debug {
 
         // Camera reference
         renderer::Camera* m_camera;
+
+        // Voxel system reference
+        voxel::VoxelSystem* m_voxelSystem;
     };
 
     class DebugSystem {
@@ -93,6 +103,9 @@ namespace debug {
         // Set camera reference
         void setCamera(renderer::Camera* camera);
 
+        // Set voxel system reference
+        void setVoxelSystem(voxel::VoxelSystem* voxelSystem);
+
         // Debug viewer access
         DebugViewer* getViewer() const;
 
@@ -4,6 +4,7 @@
 #include "input_system.h"
 #include "voxel_system.h"
 #include "debug_system.h"
+#include "linear_arena.h"
 
 #include <GLFW/glfw3.h>
 #include <iostream>
@@ -63,6 +64,9 @@ namespace engine {
             return false;
         }
 
+        // Set camera in voxel system for remesh priorities
+        m_voxelSystem->setCamera(m_camera.get());
+
         // Create debug system
         m_debugSystem = std::make_unique<debug::DebugSystem>();
         if (!m_debugSystem->initialize(m_renderer->getWindow())) {
@@ -70,8 +74,9 @@ namespace engine {
             return false;
         }
 
-        // Set camera in debug system
+        // Set camera and voxel system in debug system
         m_debugSystem->setCamera(m_camera.get());
+        m_debugSystem->setVoxelSystem(m_voxelSystem.get());
 
         m_isRunning = true;
         m_lastFrameTime = static_cast<float>(glfwGetTime());
@@ -108,6 +113,9 @@ namespace engine {
             m_deltaTime = currentTime - m_lastFrameTime;
             m_lastFrameTime = currentTime;
 
+            // Scratch from the previous frame is dead by now
+            getFrameArena().reset();
+
             // Poll for events first - this is critical for proper input handling
             glfwPollEvents();
 
@@ -166,6 +166,16 @@ namespace game {
                     m_engineCore->getDebugSystem()->getViewer()->setShowPerformanceMetrics(!show);
                 }
                 break;
+
+            case GLFW_KEY_M:
+                // Toggle between greedy and per-face chunk meshing
+                if (m_engineCore && m_engineCore->getVoxelSystem()) {
+                    voxel::VoxelSystem* voxelSystem = m_engineCore->getVoxelSystem();
+                    bool greedy = voxelSystem->getMeshingMode() == voxel::MeshingMode::GREEDY;
+                    voxelSystem->setMeshingMode(greedy ? voxel::MeshingMode::NAIVE : voxel::MeshingMode::GREEDY);
+                    std::cout << "Meshing mode: " << (greedy ? "naive" : "greedy") << std::endl;
+                }
+                break;
             }
         }
 
@@ -220,15 +230,15 @@ namespace game {
                             break;
                         }
 
-                        // Add the voxel
-                        bool success = m_engineCore->getVoxelSystem()->addVoxel(newX, newY, newZ);
+                        // Add the voxel, remeshed this frame
+                        bool success = m_engineCore->getVoxelSystem()->addVoxel(newX, newY, newZ, true);
                         if (success) {
                             std::cout << "Added voxel at (" << newX << ", " << newY << ", " << newZ << ")" << std::endl;
                         }
                     }
                     else if (button == input::MouseButton::RIGHT) {
-                        // Remove the hit voxel
-                        bool success = m_engineCore->getVoxelSystem()->removeVoxel(hitPos.x, hitPos.y, hitPos.z);
+                        // Remove the hit voxel, remeshed this frame
+                        bool success = m_engineCore->getVoxelSystem()->removeVoxel(hitPos.x, hitPos.y, hitPos.z, true);
                         if (success) {
                             std::cout << "Removed voxel at (" << hitPos.x << ", " << hitPos.y << ", " << hitPos.z << ")" << std::endl;
                         }
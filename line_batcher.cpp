@@ -0,0 +1,144 @@
+#include "line_batcher.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstring>
+
+namespace renderer {
+
+    LineBatcher::LineBatcher()
+        : m_vao(0)
+        , m_vbo(0)
+        , m_capacity(0)
+        , m_head(0)
+    {
+    }
+
+    LineBatcher::~LineBatcher() {
+        shutdown();
+    }
+
+    bool LineBatcher::initialize(size_t capacity) {
+        m_capacity = std::max<size_t>(capacity, 2);
+        m_head = 0;
+
+        glGenVertexArrays(1, &m_vao);
+        glGenBuffers(1, &m_vbo);
+
+        glBindVertexArray(m_vao);
+        glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        glBufferData(GL_ARRAY_BUFFER, m_capacity * sizeof(LineVertex), nullptr, GL_STREAM_DRAW);
+
+        // Position attribute
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(LineVertex), (void*)offsetof(LineVertex, position));
+        glEnableVertexAttribArray(0);
+
+        // Color attribute, bytes normalized to 0..1
+        glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(LineVertex), (void*)offsetof(LineVertex, color));
+        glEnableVertexAttribArray(1);
+
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        return true;
+    }
+
+    void LineBatcher::shutdown() {
+        if (m_vao) {
+            glDeleteVertexArrays(1, &m_vao);
+            m_vao = 0;
+        }
+
+        if (m_vbo) {
+            glDeleteBuffers(1, &m_vbo);
+            m_vbo = 0;
+        }
+
+        m_vertices.clear();
+        m_capacity = 0;
+        m_head = 0;
+    }
+
+    void LineBatcher::addLine(const glm::vec3& from, const glm::vec3& to, uint32_t color) {
+        LineVertex vertex;
+        vertex.color = color;
+
+        vertex.position = from;
+        m_vertices.push_back(vertex);
+        vertex.position = to;
+        m_vertices.push_back(vertex);
+    }
+
+    void LineBatcher::addLines(const float* positions, size_t floatCount, uint32_t color) {
+        size_t first = m_vertices.size();
+        size_t count = floatCount / 3;
+        m_vertices.resize(first + count);
+
+        for (size_t i = 0; i < count; i++) {
+            LineVertex& vertex = m_vertices[first + i];
+            vertex.position = glm::vec3(positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2]);
+            vertex.color = color;
+        }
+    }
+
+    void LineBatcher::clear() {
+        m_vertices.clear();
+    }
+
+    size_t LineBatcher::getVertexCount() const {
+        return m_vertices.size();
+    }
+
+    int LineBatcher::upload() {
+        size_t count = m_vertices.size();
+        if (count == 0 || !m_vbo) return 0;
+
+        if (count > m_capacity) {
+            // Grow the ring to fit the batch, the old storage is orphaned with it
+            while (m_capacity < count) {
+                m_capacity *= 2;
+            }
+            glBufferData(GL_ARRAY_BUFFER, m_capacity * sizeof(LineVertex), nullptr, GL_STREAM_DRAW);
+            m_head = 0;
+        }
+        else if (m_head + count > m_capacity) {
+            // Wrap around; orphaning hands the driver fresh storage while queued draws
+            // keep reading the old one
+            glBufferData(GL_ARRAY_BUFFER, m_capacity * sizeof(LineVertex), nullptr, GL_STREAM_DRAW);
+            m_head = 0;
+        }
+
+        // Nothing since the last orphan wrote this part of the ring, no need to synchronize
+        size_t offset = m_head * sizeof(LineVertex);
+        size_t size = count * sizeof(LineVertex);
+        void* target = glMapBufferRange(GL_ARRAY_BUFFER, offset, size,
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        if (target) {
+            std::memcpy(target, m_vertices.data(), size);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+        }
+        else {
+            glBufferSubData(GL_ARRAY_BUFFER, offset, size, m_vertices.data());
+        }
+
+        int first = static_cast<int>(m_head);
+        m_head += count;
+        return first;
+    }
+
+    unsigned int LineBatcher::getVertexArray() const {
+        return m_vao;
+    }
+
+    unsigned int LineBatcher::getBuffer() const {
+        return m_vbo;
+    }
+
+    uint32_t LineBatcher::packColor(const glm::vec3& color) {
+        // Red in the lowest byte, which is first in memory where the shader expects it
+        uint32_t r = static_cast<uint32_t>(std::clamp(color.x, 0.0f, 1.0f) * 255.0f + 0.5f);
+        uint32_t g = static_cast<uint32_t>(std::clamp(color.y, 0.0f, 1.0f) * 255.0f + 0.5f);
+        uint32_t b = static_cast<uint32_t>(std::clamp(color.z, 0.0f, 1.0f) * 255.0f + 0.5f);
+        return r | (g << 8) | (b << 16) | (255u << 24);
+    }
+
+} // namespace renderer
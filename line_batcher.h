@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace renderer {
+
+    // Line end point as the line shader reads it: position and RGBA8 color
+    struct LineVertex {
+        glm::vec3 position;
+        uint32_t color;
+    };
+
+    // Collects colored lines on the CPU and streams them into one persistent vertex
+    // buffer used as a ring. Each upload takes the next free part of the ring with an
+    // unsynchronized map; when the ring is full the buffer is orphaned and writing
+    // starts over at its beginning, so the GPU never waits on lines still being drawn.
+    // A whole batch is drawn with a single call regardless of how many colors it has.
+    class LineBatcher {
+    public:
+        LineBatcher();
+        ~LineBatcher();
+
+        LineBatcher(const LineBatcher&) = delete;
+        LineBatcher& operator=(const LineBatcher&) = delete;
+
+        // Needs the GL context, capacity is the ring size in vertices
+        bool initialize(size_t capacity = 256 * 1024);
+        void shutdown();
+
+        void addLine(const glm::vec3& from, const glm::vec3& to, uint32_t color);
+        // floatCount is three per line end point
+        void addLines(const float* positions, size_t floatCount, uint32_t color);
+        void clear();
+
+        size_t getVertexCount() const;
+
+        // Writes the batch into the ring and returns the index of its first vertex there.
+        // The ring buffer must be bound to GL_ARRAY_BUFFER.
+        int upload();
+
+        unsigned int getVertexArray() const;
+        unsigned int getBuffer() const;
+
+        static uint32_t packColor(const glm::vec3& color);
+
+    private:
+        std::vector<LineVertex> m_vertices;
+
+        unsigned int m_vao;
+        unsigned int m_vbo;
+        // Ring size and write position, in vertices
+        size_t m_capacity;
+        size_t m_head;
+    };
+
+} // namespace renderer
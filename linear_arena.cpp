@@ -0,0 +1,114 @@
+#include "linear_arena.h"
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+namespace engine {
+
+    namespace {
+        const size_t BLOCK_ALIGNMENT = 64;
+    }
+
+    LinearArena::LinearArena(size_t blockSize)
+        : m_blockSize(std::max<size_t>(blockSize, BLOCK_ALIGNMENT))
+        , m_current(0)
+        , m_offset(0)
+        , m_usedBefore(0)
+        , m_peakUsed(0)
+    {
+    }
+
+    LinearArena::~LinearArena() {
+        for (const Block& block : m_blocks) {
+            ::operator delete(block.data, std::align_val_t(BLOCK_ALIGNMENT));
+        }
+    }
+
+    void* LinearArena::allocate(size_t size, size_t alignment) {
+        while (true) {
+            if (m_current < m_blocks.size()) {
+                const Block& block = m_blocks[m_current];
+                uintptr_t base = reinterpret_cast<uintptr_t>(block.data);
+                size_t offset = ((base + m_offset + alignment - 1) & ~(uintptr_t(alignment) - 1)) - base;
+
+                if (offset + size <= block.size) {
+                    m_offset = offset + size;
+                    m_peakUsed = std::max(m_peakUsed, getUsed());
+                    return block.data + offset;
+                }
+
+                // Move on to the next block, the tail of this one stays unused
+                m_usedBefore += block.size;
+                m_current++;
+                m_offset = 0;
+                continue;
+            }
+
+            addBlock(size + alignment);
+        }
+    }
+
+    LinearArena::Marker LinearArena::getMarker() const {
+        Marker marker;
+        marker.block = m_current;
+        marker.offset = m_offset;
+        return marker;
+    }
+
+    void LinearArena::rewind(const Marker& marker) {
+        if (marker.block > m_current || (marker.block == m_current && marker.offset > m_offset)) return;
+
+        // Blocks between the marker and the current one are kept for reuse
+        m_usedBefore = 0;
+        for (size_t i = 0; i < marker.block && i < m_blocks.size(); i++) {
+            m_usedBefore += m_blocks[i].size;
+        }
+        m_current = marker.block;
+        m_offset = marker.offset;
+    }
+
+    void LinearArena::reset() {
+        // Overflowed blocks are merged so the next frame fits a single block
+        if (m_blocks.size() > 1) {
+            size_t capacity = getCapacity();
+            for (const Block& block : m_blocks) {
+                ::operator delete(block.data, std::align_val_t(BLOCK_ALIGNMENT));
+            }
+            m_blocks.clear();
+            addBlock(capacity);
+        }
+
+        m_current = 0;
+        m_offset = 0;
+        m_usedBefore = 0;
+    }
+
+    size_t LinearArena::getUsed() const {
+        return m_usedBefore + m_offset;
+    }
+
+    size_t LinearArena::getCapacity() const {
+        size_t capacity = 0;
+        for (const Block& block : m_blocks) {
+            capacity += block.size;
+        }
+        return capacity;
+    }
+
+    size_t LinearArena::getPeakUsed() const {
+        return m_peakUsed;
+    }
+
+    void LinearArena::addBlock(size_t minSize) {
+        Block block;
+        block.size = std::max(m_blockSize, (minSize + BLOCK_ALIGNMENT - 1) / BLOCK_ALIGNMENT * BLOCK_ALIGNMENT);
+        block.data = static_cast<char*>(::operator new(block.size, std::align_val_t(BLOCK_ALIGNMENT)));
+        m_blocks.push_back(block);
+    }
+
+    LinearArena& getFrameArena() {
+        thread_local LinearArena arena;
+        return arena;
+    }
+
+} // namespace engine
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace engine {
+
+    // Bump allocator for short-lived scratch memory. Allocation is a pointer bump and
+    // nothing is freed individually; reset() drops everything at once. When a frame
+    // needs more than the arena holds, overflow blocks are added and merged into one
+    // block at the next reset, so a steady workload stops touching the heap after its
+    // first few frames. Not thread safe, every thread uses its own arena.
+    class LinearArena {
+    public:
+        // Position inside the arena, everything allocated after it can be rolled back
+        struct Marker {
+            size_t block;
+            size_t offset;
+        };
+
+        explicit LinearArena(size_t blockSize = 256 * 1024);
+        ~LinearArena();
+
+        LinearArena(const LinearArena&) = delete;
+        LinearArena& operator=(const LinearArena&) = delete;
+
+        void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+        // Uninitialized storage for count objects of a trivial type
+        template <typename T>
+        T* allocateArray(size_t count) {
+            return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+        }
+
+        Marker getMarker() const;
+        void rewind(const Marker& marker);
+        void reset();
+
+        size_t getUsed() const;
+        size_t getCapacity() const;
+        // Most memory in use at once since the arena was created
+        size_t getPeakUsed() const;
+
+    private:
+        struct Block {
+            char* data;
+            size_t size;
+        };
+
+        void addBlock(size_t minSize);
+
+        std::vector<Block> m_blocks;
+        size_t m_blockSize;
+        size_t m_current;
+        size_t m_offset;
+        // Size of the blocks before m_current
+        size_t m_usedBefore;
+        size_t m_peakUsed;
+    };
+
+    // Rolls the arena back to where it was when the scope was entered
+    class ArenaScope {
+    public:
+        explicit ArenaScope(LinearArena& arena)
+            : m_arena(arena)
+            , m_marker(arena.getMarker())
+        {
+        }
+
+        ~ArenaScope() {
+            m_arena.rewind(m_marker);
+        }
+
+        ArenaScope(const ArenaScope&) = delete;
+        ArenaScope& operator=(const ArenaScope&) = delete;
+
+    private:
+        LinearArena& m_arena;
+        LinearArena::Marker m_marker;
+    };
+
+    // Standard allocator drawing from a LinearArena. Deallocation is a no-op, so
+    // containers should reserve up front: every reallocation leaves the old buffer
+    // behind until the arena is reset.
+    template <typename T>
+    class ArenaAllocator {
+    public:
+        typedef T value_type;
+
+        explicit ArenaAllocator(LinearArena& arena)
+            : m_arena(&arena)
+        {
+        }
+
+        template <typename U>
+        ArenaAllocator(const ArenaAllocator<U>& other)
+            : m_arena(other.getArena())
+        {
+        }
+
+        T* allocate(size_t count) {
+            return m_arena->allocateArray<T>(count);
+        }
+
+        void deallocate(T*, size_t) {
+        }
+
+        LinearArena* getArena() const {
+            return m_arena;
+        }
+
+        template <typename U>
+        bool operator==(const ArenaAllocator<U>& other) const {
+            return m_arena == other.getArena();
+        }
+
+        template <typename U>
+        bool operator!=(const ArenaAllocator<U>& other) const {
+            return m_arena != other.getArena();
+        }
+
+    private:
+        LinearArena* m_arena;
+    };
+
+    template <typename T>
+    using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+    // Scratch arena of the calling thread. The engine resets the main thread's arena at
+    // the start of every frame and mesh workers reset theirs before every job, so
+    // nothing allocated from it may outlive the current frame or job.
+    LinearArena& getFrameArena();
+
+} // namespace engine
@@ -43,23 +43,27 @@ int main() {
         // Set up a simple voxel world
         auto voxelSystem = engine.getVoxelSystem();
         if (voxelSystem) {
+            std::vector<voxel::VoxelEdit> edits;
+
             // Create a floor
             for (int x = -5; x <= 5; x++) {
                 for (int z = -5; z <= 5; z++) {
-                    voxelSystem->addVoxel(x, -1, z);
+                    edits.push_back({ { x, -1, z }, true });
                 }
             }
 
             // Create some simple structures
-            voxelSystem->addVoxel(2, 0, 2);
-            voxelSystem->addVoxel(2, 1, 2);
-            voxelSystem->addVoxel(2, 2, 2);
+            edits.push_back({ { 2, 0, 2 }, true });
+            edits.push_back({ { 2, 1, 2 }, true });
+            edits.push_back({ { 2, 2, 2 }, true });
+
+            edits.push_back({ { -2, 0, -2 }, true });
+            edits.push_back({ { -3, 0, -2 }, true });
+            edits.push_back({ { -2, 0, -3 }, true });
+            edits.push_back({ { -3, 0, -3 }, true });
+            edits.push_back({ { -2, 1, -2 }, true });
 
-            voxelSystem->addVoxel(-2, 0, -2);
-            voxelSystem->addVoxel(-3, 0, -2);
-            voxelSystem->addVoxel(-2, 0, -3);
-            voxelSystem->addVoxel(-3, 0, -3);
-            voxelSystem->addVoxel(-2, 1, -2);
+            voxelSystem->applyEdits(edits);
         }
 
         // Print controls
@@ -72,6 +76,7 @@ int main() {
         std::cout << "  Right Mouse Button - Remove voxel\n";
         std::cout << "  F - Toggle wireframe mode\n";
         std::cout << "  G - Toggle debug info\n";
+        std::cout << "  M - Toggle greedy/naive chunk meshing\n";
         std::cout << "  1/2/3 - Change view mode\n";
         std::cout << "  ESC - Exit\n";
         std::cout << "============================\n\n";
@@ -3,6 +3,8 @@
 
 namespace renderer {
 
+    unsigned int Mesh::s_quadIndexBuffer = 0;
+
     Mesh::Mesh()
         : m_vao(0)
         , m_vbo(0)
@@ -11,7 +13,6 @@ namespace renderer {
     {
         glGenVertexArrays(1, &m_vao);
         glGenBuffers(1, &m_vbo);
-        glGenBuffers(1, &m_ebo);
     }
 
     Mesh::~Mesh() {
@@ -31,6 +32,10 @@ namespace renderer {
     void Mesh::setVertices(const std::vector<float>& vertices, const std::vector<unsigned int>& indices) {
         m_indexCount = indices.size();
 
+        if (m_ebo == 0) {
+            glGenBuffers(1, &m_ebo);
+        }
+
         glBindVertexArray(m_vao);
 
         // Load vertex data
@@ -55,10 +60,18 @@ namespace renderer {
 
     void Mesh::draw() const {
         glBindVertexArray(m_vao);
-        glDrawElements(GL_TRIANGLES, m_indexCount, GL_UNSIGNED_INT, 0);
+        drawBound();
         glBindVertexArray(0);
     }
 
+    void Mesh::drawBound() const {
+        glDrawElements(GL_TRIANGLES, m_indexCount, GL_UNSIGNED_INT, 0);
+    }
+
+    unsigned int Mesh::getVertexArray() const {
+        return m_vao;
+    }
+
     Mesh* Mesh::createCube(float size) {
         float halfSize = size / 2.0f;
 
@@ -146,6 +159,38 @@ namespace renderer {
         return mesh;
     }
 
+    unsigned int Mesh::createQuadIndexBuffer() {
+        std::vector<unsigned short> indices;
+        indices.reserve(MAX_QUADS_PER_BATCH * 6);
+
+        for (unsigned int quad = 0; quad < MAX_QUADS_PER_BATCH; quad++) {
+            unsigned short base = static_cast<unsigned short>(quad * 4);
+            indices.insert(indices.end(), {
+                base, static_cast<unsigned short>(base + 1), static_cast<unsigned short>(base + 2),
+                base, static_cast<unsigned short>(base + 2), static_cast<unsigned short>(base + 3)
+                });
+        }
+
+        unsigned int ebo = 0;
+        glGenBuffers(1, &ebo);
+
+        // Bind with no VAO bound so no mesh picks it up by accident
+        glBindVertexArray(0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned short), indices.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+        return ebo;
+    }
+
+    void Mesh::setQuadIndexBuffer(unsigned int ebo) {
+        s_quadIndexBuffer = ebo;
+    }
+
+    unsigned int Mesh::getQuadIndexBuffer() {
+        return s_quadIndexBuffer;
+    }
+
     Mesh* Mesh::createGrid(int size, float cellSize) {
         std::vector<float> vertices;
         std::vector<unsigned int> indices;
@@ -11,17 +11,31 @@ namespace renderer {
         ~Mesh();
 
         void setVertices(const std::vector<float>& vertices, const std::vector<unsigned int>& indices);
+
         void draw() const;
+        // Issues the draw calls only; the caller has bound getVertexArray()
+        void drawBound() const;
+        unsigned int getVertexArray() const;
 
         // Utility functions for creating common shapes
         static Mesh* createCube(float size = 1.0f);
         static Mesh* createGrid(int size, float cellSize);
 
+        // Shared 16-bit quad index buffer (b, b+1, b+2, b, b+2, b+3 per quad) owned by the renderer
+        static unsigned int createQuadIndexBuffer();
+        static void setQuadIndexBuffer(unsigned int ebo);
+        static unsigned int getQuadIndexBuffer();
+
+        // Quads addressable by one 16-bit draw, larger meshes are drawn in batches
+        static const unsigned int MAX_QUADS_PER_BATCH = 16384;
+
     private:
         unsigned int m_vao;
         unsigned int m_vbo;
         unsigned int m_ebo;
         unsigned int m_indexCount;
+
+        static unsigned int s_quadIndexBuffer;
     };
 
 } // namespace renderer
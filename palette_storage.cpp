@@ -0,0 +1,156 @@
+#include "palette_storage.h"
+
+namespace voxel {
+
+    PaletteStorage::PaletteStorage(int voxelCount, MaterialId material)
+        : m_voxelCount(voxelCount)
+        , m_bitsPerVoxel(0)
+    {
+        fill(material);
+    }
+
+    MaterialId PaletteStorage::get(int index) const {
+        return m_palette[readIndex(index)];
+    }
+
+    MaterialId PaletteStorage::set(int index, MaterialId material) {
+        unsigned int oldEntry = readIndex(index);
+        MaterialId previous = m_palette[oldEntry];
+        if (previous == material) return previous;
+
+        int entry = findOrAddEntry(material);
+        m_refCounts[oldEntry]--;
+        m_refCounts[entry]++;
+        writeIndex(index, entry);
+
+        // Everything back on one material, the per-voxel data is no longer needed
+        if (m_refCounts[entry] == m_voxelCount) {
+            fill(material);
+        }
+
+        return previous;
+    }
+
+    void PaletteStorage::fill(MaterialId material) {
+        m_bitsPerVoxel = 0;
+        std::vector<uint64_t>().swap(m_data);
+        m_palette.assign(1, material);
+        m_refCounts.assign(1, m_voxelCount);
+    }
+
+    void PaletteStorage::decode(MaterialId* out) const {
+        if (m_bitsPerVoxel == 0) {
+            for (int i = 0; i < m_voxelCount; i++) out[i] = m_palette[0];
+            return;
+        }
+
+        // Unpack a whole word at a time
+        int perWord = 64 / m_bitsPerVoxel;
+        uint64_t mask = (uint64_t(1) << m_bitsPerVoxel) - 1;
+        int index = 0;
+
+        for (uint64_t word : m_data) {
+            for (int i = 0; i < perWord && index < m_voxelCount; i++, index++) {
+                out[index] = m_palette[word & mask];
+                word >>= m_bitsPerVoxel;
+            }
+        }
+    }
+
+    bool PaletteStorage::contains(MaterialId material) const {
+        for (size_t entry = 0; entry < m_palette.size(); entry++) {
+            if (m_palette[entry] == material && m_refCounts[entry] > 0) return true;
+        }
+        return false;
+    }
+
+    int PaletteStorage::count(MaterialId material) const {
+        for (size_t entry = 0; entry < m_palette.size(); entry++) {
+            if (m_palette[entry] == material) return m_refCounts[entry];
+        }
+        return 0;
+    }
+
+    MaterialId PaletteStorage::getUniformMaterial(bool& mixed) const {
+        for (size_t entry = 0; entry < m_palette.size(); entry++) {
+            if (m_refCounts[entry] == m_voxelCount) {
+                mixed = false;
+                return m_palette[entry];
+            }
+        }
+
+        mixed = true;
+        return AIR_MATERIAL;
+    }
+
+    const std::vector<MaterialId>& PaletteStorage::getPalette() const {
+        return m_palette;
+    }
+
+    int PaletteStorage::getBitsPerVoxel() const {
+        return m_bitsPerVoxel;
+    }
+
+    size_t PaletteStorage::getMemoryUsage() const {
+        return m_data.capacity() * sizeof(uint64_t) +
+            m_palette.capacity() * sizeof(MaterialId) +
+            m_refCounts.capacity() * sizeof(int);
+    }
+
+    int PaletteStorage::findOrAddEntry(MaterialId material) {
+        int freeEntry = -1;
+        for (size_t entry = 0; entry < m_palette.size(); entry++) {
+            if (m_palette[entry] == material) return static_cast<int>(entry);
+            if (freeEntry < 0 && m_refCounts[entry] == 0) freeEntry = static_cast<int>(entry);
+        }
+
+        // Reuse a slot nobody references before growing the palette
+        if (freeEntry >= 0) {
+            m_palette[freeEntry] = material;
+            return freeEntry;
+        }
+
+        int entry = static_cast<int>(m_palette.size());
+        m_palette.push_back(material);
+        m_refCounts.push_back(0);
+
+        if (entry >= (1 << m_bitsPerVoxel)) {
+            int bits = m_bitsPerVoxel == 0 ? 1 : m_bitsPerVoxel * 2;
+            resize(bits);
+        }
+
+        return entry;
+    }
+
+    void PaletteStorage::resize(int bitsPerVoxel) {
+        // Repack the current indices at the new width
+        std::vector<uint64_t> data((static_cast<size_t>(m_voxelCount) * bitsPerVoxel + 63) / 64, 0);
+        int perWord = 64 / bitsPerVoxel;
+
+        for (int index = 0; index < m_voxelCount; index++) {
+            uint64_t entry = m_bitsPerVoxel == 0 ? 0 : readIndex(index);
+            data[index / perWord] |= entry << ((index % perWord) * bitsPerVoxel);
+        }
+
+        m_data.swap(data);
+        m_bitsPerVoxel = bitsPerVoxel;
+    }
+
+    unsigned int PaletteStorage::readIndex(int index) const {
+        if (m_bitsPerVoxel == 0) return 0;
+
+        int perWord = 64 / m_bitsPerVoxel;
+        uint64_t mask = (uint64_t(1) << m_bitsPerVoxel) - 1;
+        return static_cast<unsigned int>((m_data[index / perWord] >> ((index % perWord) * m_bitsPerVoxel)) & mask);
+    }
+
+    void PaletteStorage::writeIndex(int index, unsigned int entry) {
+        int perWord = 64 / m_bitsPerVoxel;
+        int shift = (index % perWord) * m_bitsPerVoxel;
+        uint64_t mask = ((uint64_t(1) << m_bitsPerVoxel) - 1) << shift;
+
+        uint64_t& word = m_data[index / perWord];
+        word = (word & ~mask) | (static_cast<uint64_t>(entry) << shift);
+    }
+
+} // namespace voxel
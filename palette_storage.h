@@ -0,0 +1,62 @@
+#pragma once
+
+#include "voxel_system.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace voxel {
+
+    // Per-voxel material ids compressed through a palette. Each voxel stores an index
+    // into the palette using 0, 1, 2, 4, 8 or 16 bits, widening as the palette grows;
+    // a single-entry palette needs no per-voxel data at all. Widths are powers of two
+    // so entries never straddle a 64-bit word.
+    class PaletteStorage {
+    public:
+        explicit PaletteStorage(int voxelCount, MaterialId material = AIR_MATERIAL);
+
+        MaterialId get(int index) const;
+        // Returns the previous material
+        MaterialId set(int index, MaterialId material);
+        // Resets every voxel to material and drops the per-voxel data
+        void fill(MaterialId material);
+
+        // Decodes all voxels into out (voxelCount entries), word by word
+        void decode(MaterialId* out) const;
+
+        // True if any voxel uses material
+        bool contains(MaterialId material) const;
+        // Number of voxels using material
+        int count(MaterialId material) const;
+        // The material of every voxel, or AIR_MATERIAL with mixed = true when there are several
+        MaterialId getUniformMaterial(bool& mixed) const;
+
+        // Materials in use (unused palette slots are skipped), into any vector-like container
+        template <typename Container>
+        void getMaterials(Container& materials) const {
+            materials.clear();
+            for (size_t entry = 0; entry < m_palette.size(); entry++) {
+                if (m_refCounts[entry] > 0) materials.push_back(m_palette[entry]);
+            }
+        }
+        // Raw palette, may still list materials no voxel uses any more
+        const std::vector<MaterialId>& getPalette() const;
+
+        int getBitsPerVoxel() const;
+        size_t getMemoryUsage() const;
+
+    private:
+        int findOrAddEntry(MaterialId material);
+        void resize(int bitsPerVoxel);
+        unsigned int readIndex(int index) const;
+        void writeIndex(int index, unsigned int entry);
+
+        int m_voxelCount;
+        int m_bitsPerVoxel;
+        std::vector<uint64_t> m_data;
+        std::vector<MaterialId> m_palette;
+        // Voxels referencing each palette entry, entries at zero are reused
+        std::vector<int> m_refCounts;
+    };
+
+} // namespace voxel
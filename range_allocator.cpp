@@ -0,0 +1,79 @@
+#include "range_allocator.h"
+#include <algorithm>
+
+namespace renderer {
+
+    RangeAllocator::RangeAllocator(unsigned int capacity)
+        : m_capacity(0)
+        , m_used(0)
+    {
+        reset(capacity);
+    }
+
+    void RangeAllocator::reset(unsigned int capacity) {
+        m_capacity = capacity;
+        m_used = 0;
+        m_free.clear();
+        if (capacity > 0) {
+            m_free.push_back({ 0, capacity });
+        }
+    }
+
+    bool RangeAllocator::allocate(unsigned int size, unsigned int& offset) {
+        if (size == 0) return false;
+
+        for (size_t i = 0; i < m_free.size(); i++) {
+            FreeRange& range = m_free[i];
+            if (range.size < size) continue;
+
+            offset = range.offset;
+            range.offset += size;
+            range.size -= size;
+            if (range.size == 0) {
+                m_free.erase(m_free.begin() + i);
+            }
+
+            m_used += size;
+            return true;
+        }
+
+        return false;
+    }
+
+    void RangeAllocator::release(unsigned int offset, unsigned int size) {
+        if (size == 0) return;
+
+        // First free range after the released one
+        auto next = std::lower_bound(m_free.begin(), m_free.end(), offset,
+            [](const FreeRange& range, unsigned int value) { return range.offset < value; });
+
+        bool joinsPrevious = next != m_free.begin() && (next - 1)->offset + (next - 1)->size == offset;
+        bool joinsNext = next != m_free.end() && offset + size == next->offset;
+
+        if (joinsPrevious && joinsNext) {
+            (next - 1)->size += size + next->size;
+            m_free.erase(next);
+        }
+        else if (joinsPrevious) {
+            (next - 1)->size += size;
+        }
+        else if (joinsNext) {
+            next->offset = offset;
+            next->size += size;
+        }
+        else {
+            m_free.insert(next, { offset, size });
+        }
+
+        m_used -= size;
+    }
+
+    unsigned int RangeAllocator::getCapacity() const {
+        return m_capacity;
+    }
+
+    unsigned int RangeAllocator::getUsed() const {
+        return m_used;
+    }
+
+} // namespace renderer
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vector>
+
+namespace renderer {
+
+    // First-fit allocator handing out [offset, offset + size) ranges of a fixed capacity,
+    // in whatever unit the owner uses. Free ranges are kept sorted by offset and merged
+    // with their neighbours on release. Not thread safe.
+    class RangeAllocator {
+    public:
+        explicit RangeAllocator(unsigned int capacity = 0);
+
+        // Forgets every allocation
+        void reset(unsigned int capacity);
+
+        bool allocate(unsigned int size, unsigned int& offset);
+        void release(unsigned int offset, unsigned int size);
+
+        unsigned int getCapacity() const;
+        unsigned int getUsed() const;
+
+    private:
+        struct FreeRange {
+            unsigned int offset;
+            unsigned int size;
+        };
+
+        std::vector<FreeRange> m_free;
+        unsigned int m_capacity;
+        unsigned int m_used;
+    };
+
+} // namespace renderer
@@ -2,21 +2,104 @@
 #include "shader.h"
 #include "mesh.h"
 #include "camera.h"
+#include "chunk_geometry_arena.h"
+#include "linear_arena.h"
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 
+#ifndef GL_DRAW_INDIRECT_BUFFER
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#endif
+
 namespace renderer {
 
+    namespace {
+
+        // glMultiDrawElementsIndirect is OpenGL 4.3 and loaded by hand, so the renderer
+        // still starts with a 3.3 loader and context
+        typedef void (APIENTRYP MultiDrawElementsIndirectProc)(GLenum mode, GLenum type,
+            const void* indirect, GLsizei drawCount, GLsizei stride);
+        MultiDrawElementsIndirectProc s_multiDrawElementsIndirect = nullptr;
+
+        // Command layout defined by OpenGL
+        struct DrawElementsIndirectCommand {
+            GLuint count;
+            GLuint instanceCount;
+            GLuint firstIndex;
+            GLint baseVertex;
+            GLuint baseInstance;
+        };
+
+        // Vertex attribute carrying the chunk origin in the voxel shader
+        const GLuint CHUNK_ORIGIN_ATTRIBUTE = 2;
+
+        // Camera and light shared by every 3D shader for the whole frame. Matches the
+        // std140 FrameUniforms block; vec3 members take a full vec4 slot.
+        struct FrameUniforms {
+            glm::mat4 view;
+            glm::mat4 projection;
+            glm::vec4 viewPos;
+            glm::vec4 lightPos;
+            glm::vec4 lightColor;
+        };
+
+        const GLuint FRAME_UNIFORM_BINDING = 0;
+
+        // Never a GL object name, makes the next bind through the state cache go through
+        const unsigned int UNKNOWN_BINDING = 0xFFFFFFFFu;
+
+        // Render queue passes in drawing order and shader order inside a pass
+        const uint64_t PASS_SOLID = 0;
+        const uint64_t PASS_LINES = 1;
+        const uint64_t SHADER_VOXEL = 0;
+        const uint64_t SHADER_BASIC = 1;
+        const uint64_t SHADER_LINE = 2;
+
+        // Sort key: pass (4 bits), shader (8 bits), material (20 bits), depth (32 bits).
+        // Depth is a non-negative distance, whose float bits order like the values.
+        uint64_t makeSortKey(uint64_t pass, uint64_t shader, uint64_t material, float depth) {
+            uint32_t depthBits = 0;
+            float clamped = std::max(depth, 0.0f);
+            std::memcpy(&depthBits, &clamped, sizeof(depthBits));
+            return (pass << 60) | ((shader & 0xFF) << 52) | ((material & 0xFFFFF) << 32) | depthBits;
+        }
+
+        struct ChunkDepth {
+            float depth;
+            uint32_t index;
+        };
+
+    } // namespace
+
     Renderer::Renderer()
         : m_window(nullptr)
         , m_windowWidth(800)
         , m_windowHeight(600)
         , m_wireframeMode(false)
         , m_activeShader(nullptr)
+        , m_boundVertexArray(0)
+        , m_boundArrayBuffer(0)
+        , m_basicShader(nullptr)
+        , m_basicModelLocation(-1)
+        , m_basicColorLocation(-1)
+        , m_voxelShader(nullptr)
+        , m_voxelColorLocation(-1)
+        , m_lineShader(nullptr)
+        , m_uiShader(nullptr)
+        , m_uiProjectionLocation(-1)
+        , m_uiColorLocation(-1)
+        , m_uiHasTextureLocation(-1)
+        , m_frameUniformBuffer(0)
+        , m_quadIndexBuffer(0)
+        , m_multiDrawIndirect(false)
+        , m_chunkOriginBuffer(0)
+        , m_drawCommandBuffer(0)
         , m_uiVAO(0)
         , m_uiVBO(0)
         , m_camera(nullptr)
@@ -31,13 +114,17 @@ namespace renderer {
         m_windowWidth = windowWidth;
         m_windowHeight = windowHeight;
 
-        // Initialize GLFW window hints
-        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        // Create window, preferring OpenGL 4.3 for multi-draw indirect chunk rendering
+        const int contextVersions[][2] = { { 4, 3 }, { 3, 3 } };
+        for (const auto& version : contextVersions) {
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, version[0]);
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, version[1]);
+            glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+            m_window = glfwCreateWindow(windowWidth, windowHeight, title.c_str(), nullptr, nullptr);
+            if (m_window) break;
+        }
 
-        // Create window
-        m_window = glfwCreateWindow(windowWidth, windowHeight, title.c_str(), nullptr, nullptr);
         if (!m_window) {
             std::cerr << "Failed to create GLFW window" << std::endl;
             return false;
@@ -55,6 +142,26 @@ namespace renderer {
             return false;
         }
 
+        // Frame uniforms, refilled in beginFrame
+        glGenBuffers(1, &m_frameUniformBuffer);
+        glBindBuffer(GL_UNIFORM_BUFFER, m_frameUniformBuffer);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniforms), nullptr, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_UNIFORM_BINDING, m_frameUniformBuffer);
+
+        // Create the quad index buffer shared by all chunk meshes
+        m_quadIndexBuffer = Mesh::createQuadIndexBuffer();
+        Mesh::setQuadIndexBuffer(m_quadIndexBuffer);
+
+        // Per-frame chunk draw data
+        glGenBuffers(1, &m_chunkOriginBuffer);
+        if (m_multiDrawIndirect) {
+            glGenBuffers(1, &m_drawCommandBuffer);
+        }
+
+        // Streaming buffer for debug and immediate lines
+        m_lineBatcher.initialize();
+
         // Set up UI rendering
         glGenVertexArrays(1, &m_uiVAO);
         glGenBuffers(1, &m_uiVBO);
@@ -75,6 +182,7 @@ namespace renderer {
         const GLubyte* version = glGetString(GL_VERSION);
         std::cout << "Renderer: " << renderer << std::endl;
         std::cout << "OpenGL version: " << version << std::endl;
+        std::cout << "Chunk rendering: " << (m_multiDrawIndirect ? "multi-draw indirect" : "base vertex draws") << std::endl;
 
         return true;
     }
@@ -85,6 +193,34 @@ namespace renderer {
             delete pair.second;
         }
         m_shaders.clear();
+        cacheShaders();
+
+        if (m_frameUniformBuffer) {
+            glDeleteBuffers(1, &m_frameUniformBuffer);
+            m_frameUniformBuffer = 0;
+        }
+
+        // Clean up shared quad indices
+        if (m_quadIndexBuffer) {
+            Mesh::setQuadIndexBuffer(0);
+            glDeleteBuffers(1, &m_quadIndexBuffer);
+            m_quadIndexBuffer = 0;
+        }
+
+        if (m_chunkOriginBuffer) {
+            glDeleteBuffers(1, &m_chunkOriginBuffer);
+            m_chunkOriginBuffer = 0;
+        }
+
+        if (m_drawCommandBuffer) {
+            glDeleteBuffers(1, &m_drawCommandBuffer);
+            m_drawCommandBuffer = 0;
+        }
+
+        m_lineBatcher.shutdown();
+
+        m_commands.clear();
+        m_queuedChunks.clear();
 
         // Clean up UI rendering
         if (m_uiVAO) {
@@ -111,6 +247,17 @@ namespace renderer {
             return false;
         }
 
+        // Multi-draw indirect with base instances needs OpenGL 4.3
+        GLint majorVersion = 0;
+        GLint minorVersion = 0;
+        glGetIntegerv(GL_MAJOR_VERSION, &majorVersion);
+        glGetIntegerv(GL_MINOR_VERSION, &minorVersion);
+        if (majorVersion > 4 || (majorVersion == 4 && minorVersion >= 3)) {
+            s_multiDrawElementsIndirect = reinterpret_cast<MultiDrawElementsIndirectProc>(
+                glfwGetProcAddress("glMultiDrawElementsIndirect"));
+        }
+        m_multiDrawIndirect = s_multiDrawElementsIndirect != nullptr;
+
         // Set viewport
         glViewport(0, 0, m_windowWidth, m_windowHeight);
 
@@ -132,8 +279,14 @@ namespace renderer {
         layout (location = 1) in vec3 aNormal;
         
         uniform mat4 model;
-        uniform mat4 view;
-        uniform mat4 projection;
+        
+        layout (std140) uniform FrameUniforms {
+            mat4 view;
+            mat4 projection;
+            vec3 viewPos;
+            vec3 lightPos;
+            vec3 lightColor;
+        };
         
         out vec3 Normal;
         out vec3 FragPos;
@@ -152,9 +305,14 @@ namespace renderer {
         in vec3 Normal;
         in vec3 FragPos;
         
-        uniform vec3 lightPos;
-        uniform vec3 viewPos;
-        uniform vec3 lightColor;
+        layout (std140) uniform FrameUniforms {
+            mat4 view;
+            mat4 projection;
+            vec3 viewPos;
+            vec3 lightPos;
+            vec3 lightColor;
+        };
+        
         uniform vec3 objectColor;
         
         void main() {
@@ -190,15 +348,120 @@ namespace renderer {
         // Add to shader map
         m_shaders["basic"] = basicShader;
 
+        // Voxel shader for chunk meshes with packed integer vertices
+        const char* voxelVertexShaderSource = R"(
+        #version 330 core
+        layout (location = 0) in uint aPacked;
+        layout (location = 1) in uint aMaterial;
+        layout (location = 2) in vec3 aOrigin;
+        
+        layout (std140) uniform FrameUniforms {
+            mat4 view;
+            mat4 projection;
+            vec3 viewPos;
+            vec3 lightPos;
+            vec3 lightColor;
+        };
+        
+        out vec3 Normal;
+        out vec3 FragPos;
+        out float Occlusion;
+        flat out uint Material;
+        
+        const vec3 faceNormals[6] = vec3[6](
+            vec3(0.0, 0.0, -1.0), vec3(0.0, 0.0, 1.0),
+            vec3(-1.0, 0.0, 0.0), vec3(1.0, 0.0, 0.0),
+            vec3(0.0, -1.0, 0.0), vec3(0.0, 1.0, 0.0)
+        );
+        
+        void main() {
+            vec3 localPos = vec3(aPacked & 511u, (aPacked >> 9) & 511u, (aPacked >> 18) & 511u);
+            uint face = (aPacked >> 27) & 7u;
+            uint ao = (aPacked >> 30) & 3u;
+        
+            FragPos = aOrigin + localPos;
+            Normal = faceNormals[face];
+            Occlusion = 1.0 - float(ao) * 0.25;
+            Material = aMaterial & 65535u;
+            gl_Position = projection * view * vec4(FragPos, 1.0);
+        }
+    )";
+
+        const char* voxelFragmentShaderSource = R"(
+        #version 330 core
+        out vec4 FragColor;
+        
+        in vec3 Normal;
+        in vec3 FragPos;
+        in float Occlusion;
+        flat in uint Material;
+        
+        layout (std140) uniform FrameUniforms {
+            mat4 view;
+            mat4 projection;
+            vec3 viewPos;
+            vec3 lightPos;
+            vec3 lightColor;
+        };
+        
+        uniform vec3 objectColor;
+        
+        void main() {
+            // The default material uses the chunk color, others get a stable tint per id
+            vec3 baseColor = objectColor;
+            if (Material > 1u) {
+                baseColor = 0.3 + 0.6 * fract(vec3(Material) * vec3(0.618034, 0.381966, 0.127));
+            }
+            
+            // Ambient
+            float ambientStrength = 0.3;
+            vec3 ambient = ambientStrength * Occlusion * lightColor;
+            
+            // Diffuse
+            vec3 lightDir = normalize(lightPos - FragPos);
+            float diff = max(dot(Normal, lightDir), 0.0);
+            vec3 diffuse = diff * lightColor;
+            
+            // Specular
+            float specularStrength = 0.5;
+            vec3 viewDir = normalize(viewPos - FragPos);
+            vec3 reflectDir = reflect(-lightDir, Normal);
+            float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32);
+            vec3 specular = specularStrength * spec * lightColor;
+            
+            vec3 result = (ambient + diffuse + specular) * baseColor;
+            FragColor = vec4(result, 1.0);
+        }
+    )";
+
+        // Create voxel shader
+        Shader* voxelShader = new Shader();
+        if (!voxelShader->compile(voxelVertexShaderSource, voxelFragmentShaderSource)) {
+            delete voxelShader;
+            return false;
+        }
+
+        // Add to shader map
+        m_shaders["voxel"] = voxelShader;
+
         // Line shader for grid and debug lines
         const char* lineVertexShaderSource = R"(
         #version 330 core
         layout (location = 0) in vec3 aPos;
+        layout (location = 1) in vec4 aColor;
         
-        uniform mat4 view;
-        uniform mat4 projection;
+        layout (std140) uniform FrameUniforms {
+            mat4 view;
+            mat4 projection;
+            vec3 viewPos;
+            vec3 lightPos;
+            vec3 lightColor;
+        };
+        
+        out vec4 Color;
         
         void main() {
+            Color = aColor;
             gl_Position = projection * view * vec4(aPos, 1.0);
         }
     )";
@@ -207,10 +470,10 @@ namespace renderer {
         #version 330 core
         out vec4 FragColor;
         
-        uniform vec3 lineColor;
+        in vec4 Color;
         
         void main() {
-            FragColor = vec4(lineColor, 1.0);
+            FragColor = Color;
         }
     )";
 
@@ -270,20 +533,107 @@ namespace renderer {
         // Add to shader map
         m_shaders["ui"] = uiShader;
 
+        cacheShaders();
+
         return true;
     }
 
+    void Renderer::cacheShaders() {
+        m_basicShader = getShader("basic");
+        m_voxelShader = getShader("voxel");
+        m_lineShader = getShader("line");
+        m_uiShader = getShader("ui");
+
+        for (Shader* shader : { m_basicShader, m_voxelShader, m_lineShader }) {
+            if (shader) {
+                shader->bindUniformBlock("FrameUniforms", FRAME_UNIFORM_BINDING);
+            }
+        }
+
+        m_basicModelLocation = m_basicShader ? m_basicShader->getUniformLocation("model") : -1;
+        m_basicColorLocation = m_basicShader ? m_basicShader->getUniformLocation("objectColor") : -1;
+        m_voxelColorLocation = m_voxelShader ? m_voxelShader->getUniformLocation("objectColor") : -1;
+        m_uiProjectionLocation = m_uiShader ? m_uiShader->getUniformLocation("projection") : -1;
+        m_uiColorLocation = m_uiShader ? m_uiShader->getUniformLocation("color") : -1;
+        m_uiHasTextureLocation = m_uiShader ? m_uiShader->getUniformLocation("hasTexture") : -1;
+    }
+
     void Renderer::beginFrame() {
         // Clear the screen
         glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        m_stats = RenderStats();
+        updateFrameUniforms();
+    }
+
+    void Renderer::updateFrameUniforms() {
+        if (!m_frameUniformBuffer) return;
+
+        FrameUniforms uniforms;
+        if (m_camera) {
+            uniforms.view = m_camera->getViewMatrix();
+            uniforms.projection = m_camera->getProjectionMatrix();
+            uniforms.viewPos = glm::vec4(m_camera->getPosition(), 1.0f);
+        }
+        else {
+            uniforms.view = glm::mat4(1.0f);
+            uniforms.projection = glm::mat4(1.0f);
+            uniforms.viewPos = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+        }
+        uniforms.lightPos = glm::vec4(5.0f, 5.0f, 5.0f, 1.0f);
+        uniforms.lightColor = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+
+        glBindBuffer(GL_UNIFORM_BUFFER, m_frameUniformBuffer);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameUniforms), &uniforms);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
     }
 
     void Renderer::endFrame() {
+        flush();
+        m_lastStats = m_stats;
+
         // Swap buffers
         glfwSwapBuffers(m_window);
     }
 
+    void Renderer::flush() {
+        // Meshes, chunk geometry and line uploads bind outside the cache between flushes,
+        // so the cache never outlives one, even when nothing is queued
+        resetStateCache();
+
+        if (m_commands.empty()) return;
+
+        // Equal keys fall back to submission order. Unlike std::stable_sort this needs no
+        // temporary buffer, so sorting twice a frame does not allocate.
+        std::sort(m_commands.begin(), m_commands.end(),
+            [](const RenderCommand& a, const RenderCommand& b) {
+                if (a.key != b.key) return a.key < b.key;
+                return a.order < b.order;
+            });
+
+        for (const RenderCommand& command : m_commands) {
+            switch (command.type) {
+            case CommandType::MESH:
+                executeMesh(command);
+                break;
+            case CommandType::CHUNKS:
+                executeChunks(command);
+                break;
+            case CommandType::LINES:
+                executeLines(command);
+                break;
+            }
+        }
+
+        // Leave no vertex array bound for code outside the renderer
+        bindVertexArray(0);
+
+        m_commands.clear();
+        m_queuedChunks.clear();
+        m_lineBatcher.clear();
+    }
+
     void Renderer::setWireframeMode(bool enabled) {
         m_wireframeMode = enabled;
         if (enabled) {
@@ -302,94 +652,269 @@ namespace renderer {
         m_camera = camera;
     }
 
-    // Fix the drawMesh method to use m_camera if available
     void Renderer::drawMesh(const Mesh* mesh, const glm::mat4& modelMatrix, const glm::vec3& color) {
-        if (!mesh) return;
-
-        // Use basic shader
-        Shader* shader = getShader("basic");
-        if (!shader) return;
-
-        shader->use();
-
-        // Set uniforms
-        shader->setMat4("model", modelMatrix);
+        if (!mesh || !m_basicShader) return;
 
+        // Nearer meshes of the same vertex array first
+        float depth = 0.0f;
         if (m_camera) {
-            shader->setMat4("view", m_camera->getViewMatrix());
-            shader->setMat4("projection", m_camera->getProjectionMatrix());
-            shader->setVec3("viewPos", m_camera->getPosition());
-        }
-        else {
-            shader->setMat4("view", glm::mat4(1.0f));
-            shader->setMat4("projection", glm::mat4(1.0f));
-            shader->setVec3("viewPos", glm::vec3(0.0f));
+            depth = glm::length(glm::vec3(modelMatrix[3]) - m_camera->getPosition());
         }
 
-        shader->setVec3("objectColor", color);
-        shader->setVec3("lightPos", glm::vec3(5.0f, 5.0f, 5.0f));
-        shader->setVec3("lightColor", glm::vec3(1.0f, 1.0f, 1.0f));
+        RenderCommand command;
+        command.key = makeSortKey(PASS_SOLID, SHADER_BASIC, mesh->getVertexArray(), depth);
+        command.order = static_cast<uint32_t>(m_commands.size());
+        command.type = CommandType::MESH;
+        command.mesh = mesh;
+        command.arena = nullptr;
+        command.model = modelMatrix;
+        command.color = color;
+        command.first = 0;
+        command.count = 0;
+        m_commands.push_back(command);
+    }
+
+    void Renderer::drawChunks(const ChunkGeometryArena& arena, const ChunkDraw* draws, size_t count,
+        const glm::vec3& color) {
+        if (count == 0 || !m_voxelShader) return;
+
+        RenderCommand command;
+        command.key = makeSortKey(PASS_SOLID, SHADER_VOXEL, 0, 0.0f);
+        command.order = static_cast<uint32_t>(m_commands.size());
+        command.type = CommandType::CHUNKS;
+        command.mesh = nullptr;
+        command.arena = &arena;
+        command.model = glm::mat4(1.0f);
+        command.color = color;
+        command.first = m_queuedChunks.size();
+        command.count = count;
+        m_commands.push_back(command);
+
+        m_queuedChunks.insert(m_queuedChunks.end(), draws, draws + count);
+    }
+
+    void Renderer::drawLine(const glm::vec3& from, const glm::vec3& to, const glm::vec3& color) {
+        if (!m_lineShader) return;
 
-        // Draw mesh
-        mesh->draw();
+        queueLineBatch();
+        m_lineBatcher.addLine(from, to, LineBatcher::packColor(color));
     }
 
-    // Fix the drawLines method to use m_camera if available
     void Renderer::drawLines(const std::vector<float>& vertices, const glm::vec3& color) {
-        if (vertices.empty()) return;
+        drawLines(vertices.data(), vertices.size(), color);
+    }
 
-        // Use line shader
-        Shader* shader = getShader("line");
-        if (!shader) return;
+    void Renderer::drawLines(const float* vertices, size_t floatCount, const glm::vec3& color) {
+        if (floatCount == 0 || !m_lineShader) return;
 
-        shader->use();
+        queueLineBatch();
+        m_lineBatcher.addLines(vertices, floatCount, LineBatcher::packColor(color));
+    }
 
-        // Set uniforms
-        if (m_camera) {
-            shader->setMat4("view", m_camera->getViewMatrix());
-            shader->setMat4("projection", m_camera->getProjectionMatrix());
+    void Renderer::queueLineBatch() {
+        // The first line of a flush queues the command that draws the whole batch
+        if (m_lineBatcher.getVertexCount() > 0) return;
+
+        RenderCommand command;
+        command.key = makeSortKey(PASS_LINES, SHADER_LINE, 0, 0.0f);
+        command.order = static_cast<uint32_t>(m_commands.size());
+        command.type = CommandType::LINES;
+        command.mesh = nullptr;
+        command.arena = nullptr;
+        command.model = glm::mat4(1.0f);
+        command.color = glm::vec3(1.0f);
+        command.first = 0;
+        command.count = 0;
+        m_commands.push_back(command);
+    }
+
+    void Renderer::executeMesh(const RenderCommand& command) {
+        useShader(m_basicShader);
+        m_basicShader->setMat4(m_basicModelLocation, command.model);
+        m_basicShader->setVec3(m_basicColorLocation, command.color);
+
+        bindVertexArray(command.mesh->getVertexArray());
+        command.mesh->drawBound();
+        m_stats.drawCalls++;
+    }
+
+    void Renderer::executeChunks(const RenderCommand& command) {
+        const ChunkGeometryArena& arena = *command.arena;
+        size_t count = command.count;
+
+        useShader(m_voxelShader);
+        m_voxelShader->setVec3(m_voxelColorLocation, command.color);
+
+        engine::LinearArena& frameArena = engine::getFrameArena();
+        engine::ArenaScope scope(frameArena);
+
+        // Front to back, so nearer chunks fill the depth buffer before the ones they hide.
+        // Within a page the draw order is also the command order of its multi-draw.
+        const ChunkDraw* queued = m_queuedChunks.data() + command.first;
+        ChunkDepth* depths = frameArena.allocateArray<ChunkDepth>(count);
+        glm::vec3 eye = m_camera ? m_camera->getPosition() : glm::vec3(0.0f);
+        for (size_t i = 0; i < count; i++) {
+            glm::vec3 offset = queued[i].center - eye;
+            depths[i].depth = glm::dot(offset, offset);
+            depths[i].index = static_cast<uint32_t>(i);
+        }
+        std::sort(depths, depths + count,
+            [](const ChunkDepth& a, const ChunkDepth& b) { return a.depth < b.depth; });
+
+        ChunkDraw* draws = frameArena.allocateArray<ChunkDraw>(count);
+        for (size_t i = 0; i < count; i++) {
+            draws[i] = queued[depths[i].index];
+        }
+
+        if (m_multiDrawIndirect) {
+            // One origin per chunk, picked by the base instance of its commands through the
+            // instanced origin attribute. Chunks past the 16-bit index range take several commands.
+            size_t commandCount = 0;
+            for (size_t i = 0; i < count; i++) {
+                commandCount += (draws[i].range.quadCount + Mesh::MAX_QUADS_PER_BATCH - 1) / Mesh::MAX_QUADS_PER_BATCH;
+            }
+
+            glm::vec3* origins = frameArena.allocateArray<glm::vec3>(count);
+            DrawElementsIndirectCommand* commands = frameArena.allocateArray<DrawElementsIndirectCommand>(commandCount);
+            int* pageFirst = frameArena.allocateArray<int>(arena.getPageCount() + 1);
+
+            // Commands grouped by page so each page is a single multi-draw
+            size_t next = 0;
+            for (int page = 0; page < arena.getPageCount(); page++) {
+                pageFirst[page] = static_cast<int>(next);
+
+                for (size_t i = 0; i < count; i++) {
+                    const GeometryRange& range = draws[i].range;
+                    if (range.page != page) continue;
+
+                    origins[i] = draws[i].origin;
+                    for (unsigned int first = 0; first < range.quadCount; first += Mesh::MAX_QUADS_PER_BATCH) {
+                        DrawElementsIndirectCommand& cmd = commands[next++];
+                        cmd.count = std::min(range.quadCount - first, Mesh::MAX_QUADS_PER_BATCH) * 6;
+                        cmd.instanceCount = 1;
+                        cmd.firstIndex = 0;
+                        cmd.baseVertex = static_cast<GLint>((range.firstQuad + first) * 4);
+                        cmd.baseInstance = static_cast<GLuint>(i);
+                    }
+                }
+            }
+            pageFirst[arena.getPageCount()] = static_cast<int>(next);
+
+            bindArrayBuffer(m_chunkOriginBuffer);
+            glBufferData(GL_ARRAY_BUFFER, count * sizeof(glm::vec3), origins, GL_STREAM_DRAW);
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_drawCommandBuffer);
+            glBufferData(GL_DRAW_INDIRECT_BUFFER, next * sizeof(DrawElementsIndirectCommand), commands, GL_STREAM_DRAW);
+
+            for (int page = 0; page < arena.getPageCount(); page++) {
+                int pageCommands = pageFirst[page + 1] - pageFirst[page];
+                if (pageCommands == 0) continue;
+
+                bindVertexArray(arena.getVertexArray(page));
+                bindArrayBuffer(m_chunkOriginBuffer);
+                glVertexAttribPointer(CHUNK_ORIGIN_ATTRIBUTE, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
+                glVertexAttribDivisor(CHUNK_ORIGIN_ATTRIBUTE, 1);
+                glEnableVertexAttribArray(CHUNK_ORIGIN_ATTRIBUTE);
+
+                s_multiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_SHORT,
+                    (void*)(pageFirst[page] * sizeof(DrawElementsIndirectCommand)), pageCommands, 0);
+                m_stats.drawCalls++;
+            }
+
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
         }
         else {
-            shader->setMat4("view", glm::mat4(1.0f));
-            shader->setMat4("projection", glm::mat4(1.0f));
+            // Without indirect draws each chunk is still only a base vertex draw, one vertex
+            // array bind per page and the origin as a constant attribute
+            for (int page = 0; page < arena.getPageCount(); page++) {
+                bool bound = false;
+
+                for (size_t i = 0; i < count; i++) {
+                    const GeometryRange& range = draws[i].range;
+                    if (range.page != page) continue;
+
+                    if (!bound) {
+                        bindVertexArray(arena.getVertexArray(page));
+                        glDisableVertexAttribArray(CHUNK_ORIGIN_ATTRIBUTE);
+                        bound = true;
+                    }
+
+                    const glm::vec3& origin = draws[i].origin;
+                    glVertexAttrib3f(CHUNK_ORIGIN_ATTRIBUTE, origin.x, origin.y, origin.z);
+
+                    for (unsigned int first = 0; first < range.quadCount; first += Mesh::MAX_QUADS_PER_BATCH) {
+                        unsigned int quads = std::min(range.quadCount - first, Mesh::MAX_QUADS_PER_BATCH);
+                        glDrawElementsBaseVertex(GL_TRIANGLES, quads * 6, GL_UNSIGNED_SHORT, 0,
+                            static_cast<GLint>((range.firstQuad + first) * 4));
+                        m_stats.drawCalls++;
+                    }
+                }
+            }
         }
 
-        shader->setVec3("lineColor", color);
+    }
 
-        // Create temporary VAO and VBO
-        unsigned int VAO, VBO;
-        glGenVertexArrays(1, &VAO);
-        glGenBuffers(1, &VBO);
+    void Renderer::executeLines(const RenderCommand&) {
+        size_t count = m_lineBatcher.getVertexCount();
+        if (count == 0) return;
 
-        glBindVertexArray(VAO);
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+        useShader(m_lineShader);
 
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-        glEnableVertexAttribArray(0);
+        bindArrayBuffer(m_lineBatcher.getBuffer());
+        int first = m_lineBatcher.upload();
 
-        // Draw lines
-        glDrawArrays(GL_LINES, 0, vertices.size() / 3);
+        bindVertexArray(m_lineBatcher.getVertexArray());
+        glDrawArrays(GL_LINES, first, static_cast<GLsizei>(count));
+        m_stats.drawCalls++;
 
-        // Clean up
-        glDeleteVertexArrays(1, &VAO);
-        glDeleteBuffers(1, &VBO);
+        m_lineBatcher.clear();
+    }
+
+    void Renderer::useShader(Shader* shader) {
+        if (m_activeShader == shader) return;
+
+        shader->use();
+        m_activeShader = shader;
+        m_stats.programBinds++;
+    }
+
+    void Renderer::bindVertexArray(unsigned int vertexArray) {
+        if (m_boundVertexArray == vertexArray) return;
+
+        glBindVertexArray(vertexArray);
+        m_boundVertexArray = vertexArray;
+        m_stats.vertexArrayBinds++;
+    }
+
+    void Renderer::bindArrayBuffer(unsigned int buffer) {
+        if (m_boundArrayBuffer == buffer) return;
+
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        m_boundArrayBuffer = buffer;
+        m_stats.bufferBinds++;
+    }
+
+    void Renderer::resetStateCache() {
+        m_activeShader = nullptr;
+        m_boundVertexArray = UNKNOWN_BINDING;
+        m_boundArrayBuffer = UNKNOWN_BINDING;
     }
 
     void Renderer::beginUI() {
+        // Queued 3D draws go underneath the UI
+        flush();
+
         // Disable depth testing for UI
         glDisable(GL_DEPTH_TEST);
 
         // Use UI shader
-        Shader* shader = getShader("ui");
-        if (!shader) return;
+        if (!m_uiShader) return;
 
-        shader->use();
+        useShader(m_uiShader);
 
         // Set orthographic projection
         glm::mat4 projection = glm::ortho(0.0f, static_cast<float>(m_windowWidth),
             static_cast<float>(m_windowHeight), 0.0f, -1.0f, 1.0f);
-        shader->setMat4("projection", projection);
+        m_uiShader->setMat4(m_uiProjectionLocation, projection);
     }
 
     void Renderer::endUI() {
@@ -410,12 +935,11 @@ namespace renderer {
     }
 
     void Renderer::drawRect(float x, float y, float width, float height, const glm::vec4& color) {
-        Shader* shader = getShader("ui");
-        if (!shader) return;
+        if (!m_uiShader) return;
 
-        shader->use();
-        shader->setBool("hasTexture", false);
-        shader->setVec4("color", color);
+        useShader(m_uiShader);
+        m_uiShader->setBool(m_uiHasTextureLocation, false);
+        m_uiShader->setVec4(m_uiColorLocation, color);
 
         float vertices[] = {
             // positions        // texture coords
@@ -425,11 +949,12 @@ namespace renderer {
             x,          y + height,  0.0f, 1.0f
         };
 
-        glBindVertexArray(m_uiVAO);
-        glBindBuffer(GL_ARRAY_BUFFER, m_uiVBO);
+        bindVertexArray(m_uiVAO);
+        bindArrayBuffer(m_uiVBO);
         glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_DYNAMIC_DRAW);
 
         glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+        m_stats.drawCalls++;
     }
 
     void Renderer::drawLine2D(float x1, float y1, float x2, float y2, const glm::vec3& color, float thickness) {
@@ -453,6 +978,14 @@ namespace renderer {
         drawRect(p1.x, p1.y, p3.x - p1.x, p3.y - p1.y, glm::vec4(color, 1.0f));
     }
 
+    bool Renderer::hasMultiDrawIndirect() const {
+        return m_multiDrawIndirect;
+    }
+
+    const RenderStats& Renderer::getStats() const {
+        return m_lastStats;
+    }
+
     GLFWwindow* Renderer::getWindow() const {
         return m_window;
     }
@@ -484,6 +1017,9 @@ namespace renderer {
             delete m_shaders[name];
         }
         m_shaders[name] = shader;
+
+        // A replaced default shader needs its uniforms resolved again
+        cacheShaders();
     }
 
 } // namespace renderer
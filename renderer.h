@@ -1,9 +1,11 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <unordered_map>
 #include <glm/glm.hpp>
+#include "line_batcher.h"
 
 struct GLFWwindow;
 
@@ -12,6 +14,16 @@ namespace renderer {
     class Shader;
     class Mesh;
     class Camera;
+    class ChunkGeometryArena;
+    struct ChunkDraw;
+
+    // GL work of one frame, counted as the render queue executes it
+    struct RenderStats {
+        int drawCalls = 0;
+        int programBinds = 0;
+        int vertexArrayBinds = 0;
+        int bufferBinds = 0;
+    };
 
     class Renderer {
     public:
@@ -22,13 +34,28 @@ namespace renderer {
         void shutdown();
 
         void beginFrame();
+        // Flushes the render queue and presents the frame
         void endFrame();
 
+        // Draws everything queued so far. 3D draws are only recorded when submitted and
+        // executed here sorted by pass, shader, material and depth, so anything that
+        // must appear on top of them (UI, ImGui) flushes first.
+        void flush();
+
         void setWireframeMode(bool enabled);
         bool isWireframeMode() const;
 
+        // The mesh must stay alive until the next flush
         void drawMesh(const Mesh* mesh, const glm::mat4& modelMatrix, const glm::vec3& color = glm::vec3(1.0f));
+        // Queues chunk ranges of the geometry arena for the voxel shader. They are drawn
+        // front to back, one multi-draw per arena page where supported.
+        void drawChunks(const ChunkGeometryArena& arena, const ChunkDraw* draws, size_t count,
+            const glm::vec3& color = glm::vec3(1.0f));
+        // Lines of a flush are batched with per-vertex colors and drawn in one call
+        void drawLine(const glm::vec3& from, const glm::vec3& to, const glm::vec3& color = glm::vec3(1.0f));
         void drawLines(const std::vector<float>& vertices, const glm::vec3& color = glm::vec3(1.0f));
+        // floatCount is three per line end point
+        void drawLines(const float* vertices, size_t floatCount, const glm::vec3& color = glm::vec3(1.0f));
 
         // 2D rendering for UI
         void beginUI();
@@ -43,6 +70,12 @@ namespace renderer {
         int getWindowHeight() const;
         void setViewport(int width, int height);
 
+        // True when chunks are drawn with glMultiDrawElementsIndirect (OpenGL 4.3)
+        bool hasMultiDrawIndirect() const;
+
+        // Counts of the last finished frame
+        const RenderStats& getStats() const;
+
         // Shader management
         Shader* getShader(const std::string& name);
         void addShader(const std::string& name, Shader* shader);
@@ -51,8 +84,46 @@ namespace renderer {
         void setCamera(renderer::Camera* camera);
 
     private:
+        enum class CommandType {
+            MESH,
+            CHUNKS,
+            LINES
+        };
+
+        // A queued draw. Chunk draws are copied into the queue's own array, first and
+        // count index into it. Lines take a single command for the whole line batch.
+        struct RenderCommand {
+            uint64_t key;
+            // Submission index, keeps commands with equal keys in the order they came in
+            uint32_t order;
+            CommandType type;
+            const Mesh* mesh;
+            const ChunkGeometryArena* arena;
+            glm::mat4 model;
+            glm::vec3 color;
+            size_t first;
+            size_t count;
+        };
+
+        void executeMesh(const RenderCommand& command);
+        void executeChunks(const RenderCommand& command);
+        void executeLines(const RenderCommand& command);
+        // Queues the line batch command unless this flush has one already
+        void queueLineBatch();
+
+        // Binds through the state cache, skipping what is bound already
+        void useShader(Shader* shader);
+        void bindVertexArray(unsigned int vertexArray);
+        void bindArrayBuffer(unsigned int buffer);
+        // Forgets the cached bindings after GL state was changed behind the cache
+        void resetStateCache();
+
         bool initializeOpenGL();
         bool createDefaultShaders();
+        // Looks up the default shaders and their per-draw uniform locations
+        void cacheShaders();
+        // Uploads camera and light to the frame uniform buffer
+        void updateFrameUniforms();
 
         GLFWwindow* m_window;
         int m_windowWidth;
@@ -61,7 +132,46 @@ namespace renderer {
 
         // Shaders
         std::unordered_map<std::string, Shader*> m_shaders;
+        // Bound program, vertex array and array buffer as far as the state cache knows
         Shader* m_activeShader;
+        unsigned int m_boundVertexArray;
+        unsigned int m_boundArrayBuffer;
+
+        // Default shaders and the uniforms set per draw, resolved once so drawing skips
+        // the name lookups
+        Shader* m_basicShader;
+        int m_basicModelLocation;
+        int m_basicColorLocation;
+        Shader* m_voxelShader;
+        int m_voxelColorLocation;
+        Shader* m_lineShader;
+        Shader* m_uiShader;
+        int m_uiProjectionLocation;
+        int m_uiColorLocation;
+        int m_uiHasTextureLocation;
+
+        // View, projection, camera position and light shared by the 3D shaders
+        // (FrameUniforms block), written once per frame in beginFrame
+        unsigned int m_frameUniformBuffer;
+
+        // Shared index buffer for all quad meshes
+        unsigned int m_quadIndexBuffer;
+
+        // Chunk batches: per-draw origins (instanced attribute 2) and indirect commands,
+        // refilled every drawChunks call
+        bool m_multiDrawIndirect;
+        unsigned int m_chunkOriginBuffer;
+        unsigned int m_drawCommandBuffer;
+
+        // Render queue, cleared by every flush
+        std::vector<RenderCommand> m_commands;
+        std::vector<ChunkDraw> m_queuedChunks;
+
+        // Lines of the current flush
+        LineBatcher m_lineBatcher;
+
+        RenderStats m_stats;
+        RenderStats m_lastStats;
 
         // OpenGL objects for UI rendering
         unsigned int m_uiVAO;
@@ -2,6 +2,7 @@
 #include <glad/glad.h>
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
+#include <vector>
 
 namespace renderer {
 
@@ -68,6 +69,8 @@ namespace renderer {
         glDeleteShader(vertexShader);
         glDeleteShader(fragmentShader);
 
+        cacheUniformLocations();
+
         return true;
     }
 
@@ -75,40 +78,120 @@ namespace renderer {
         glUseProgram(m_id);
     }
 
+    int Shader::getUniformLocation(const std::string& name) const {
+        auto it = m_uniformLocations.find(name);
+        if (it != m_uniformLocations.end()) {
+            return it->second;
+        }
+
+        // Indexed names the cache missed still go to the driver, as they did before caching
+        if (name.find('[') != std::string::npos) {
+            return glGetUniformLocation(m_id, name.c_str());
+        }
+        return -1;
+    }
+
+    bool Shader::bindUniformBlock(const char* blockName, unsigned int binding) {
+        unsigned int index = glGetUniformBlockIndex(m_id, blockName);
+        if (index == GL_INVALID_INDEX) return false;
+
+        glUniformBlockBinding(m_id, index, binding);
+        return true;
+    }
+
+    void Shader::cacheUniformLocations() {
+        m_uniformLocations.clear();
+
+        int count = 0;
+        int maxLength = 0;
+        glGetProgramiv(m_id, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(m_id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+        std::vector<char> name(maxLength > 0 ? maxLength : 1);
+        for (int i = 0; i < count; i++) {
+            GLsizei length = 0;
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(m_id, i, static_cast<GLsizei>(name.size()), &length, &size, &type, name.data());
+
+            // Members of uniform blocks have no location, they are set through the block's buffer
+            int location = glGetUniformLocation(m_id, name.data());
+            if (location < 0) continue;
+
+            std::string uniform(name.data(), length);
+            m_uniformLocations[uniform] = location;
+
+            // Arrays are reported by their first element. They are also set through their
+            // bare name, and every element is looked up once so "lights[2]" hits the cache.
+            if (uniform.size() > 3 && uniform.compare(uniform.size() - 3, 3, "[0]") == 0) {
+                std::string base = uniform.substr(0, uniform.size() - 3);
+                m_uniformLocations[base] = location;
+                for (int element = 1; element < size; element++) {
+                    std::string elementName = base + "[" + std::to_string(element) + "]";
+                    m_uniformLocations[elementName] = glGetUniformLocation(m_id, elementName.c_str());
+                }
+            }
+        }
+    }
+
     void Shader::setBool(const std::string& name, bool value) {
-        glUniform1i(glGetUniformLocation(m_id, name.c_str()), (int)value);
+        glUniform1i(getUniformLocation(name), (int)value);
     }
 
     void Shader::setInt(const std::string& name, int value) {
-        glUniform1i(glGetUniformLocation(m_id, name.c_str()), value);
+        glUniform1i(getUniformLocation(name), value);
     }
 
     void Shader::setFloat(const std::string& name, float value) {
-        glUniform1f(glGetUniformLocation(m_id, name.c_str()), value);
+        glUniform1f(getUniformLocation(name), value);
     }
 
     void Shader::setVec2(const std::string& name, const glm::vec2& value) {
-        glUniform2fv(glGetUniformLocation(m_id, name.c_str()), 1, glm::value_ptr(value));
+        glUniform2fv(getUniformLocation(name), 1, glm::value_ptr(value));
     }
 
     void Shader::setVec3(const std::string& name, const glm::vec3& value) {
-        glUniform3fv(glGetUniformLocation(m_id, name.c_str()), 1, glm::value_ptr(value));
+        glUniform3fv(getUniformLocation(name), 1, glm::value_ptr(value));
     }
 
     void Shader::setVec4(const std::string& name, const glm::vec4& value) {
-        glUniform4fv(glGetUniformLocation(m_id, name.c_str()), 1, glm::value_ptr(value));
+        glUniform4fv(getUniformLocation(name), 1, glm::value_ptr(value));
     }
 
     void Shader::setMat2(const std::string& name, const glm::mat2& value) {
-        glUniformMatrix2fv(glGetUniformLocation(m_id, name.c_str()), 1, GL_FALSE, glm::value_ptr(value));
+        glUniformMatrix2fv(getUniformLocation(name), 1, GL_FALSE, glm::value_ptr(value));
     }
 
     void Shader::setMat3(const std::string& name, const glm::mat3& value) {
-        glUniformMatrix3fv(glGetUniformLocation(m_id, name.c_str()), 1, GL_FALSE, glm::value_ptr(value));
+        glUniformMatrix3fv(getUniformLocation(name), 1, GL_FALSE, glm::value_ptr(value));
     }
 
     void Shader::setMat4(const std::string& name, const glm::mat4& value) {
-        glUniformMatrix4fv(glGetUniformLocation(m_id, name.c_str()), 1, GL_FALSE, glm::value_ptr(value));
+        glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, glm::value_ptr(value));
+    }
+
+    void Shader::setBool(int location, bool value) {
+        glUniform1i(location, (int)value);
+    }
+
+    void Shader::setInt(int location, int value) {
+        glUniform1i(location, value);
+    }
+
+    void Shader::setFloat(int location, float value) {
+        glUniform1f(location, value);
+    }
+
+    void Shader::setVec3(int location, const glm::vec3& value) {
+        glUniform3fv(location, 1, glm::value_ptr(value));
+    }
+
+    void Shader::setVec4(int location, const glm::vec4& value) {
+        glUniform4fv(location, 1, glm::value_ptr(value));
+    }
+
+    void Shader::setMat4(int location, const glm::mat4& value) {
+        glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value));
     }
 
 } // namespace renderer
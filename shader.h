@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <unordered_map>
 #include <glm/glm.hpp>
 
 namespace renderer {
@@ -13,6 +14,13 @@ namespace renderer {
         bool compile(const char* vertexSource, const char* fragmentSource);
         void use();
 
+        // Location of an active uniform, -1 if the program has none by that name.
+        // Locations are looked up once when the program links.
+        int getUniformLocation(const std::string& name) const;
+
+        // Connects a uniform block of the program to a buffer binding point
+        bool bindUniformBlock(const char* blockName, unsigned int binding);
+
         // Utility functions for setting uniforms
         void setBool(const std::string& name, bool value);
         void setInt(const std::string& name, int value);
@@ -24,8 +32,19 @@ namespace renderer {
         void setMat3(const std::string& name, const glm::mat3& value);
         void setMat4(const std::string& name, const glm::mat4& value);
 
+        // Same by cached location, for uniforms set every draw
+        void setBool(int location, bool value);
+        void setInt(int location, int value);
+        void setFloat(int location, float value);
+        void setVec3(int location, const glm::vec3& value);
+        void setVec4(int location, const glm::vec4& value);
+        void setMat4(int location, const glm::mat4& value);
+
     private:
+        void cacheUniformLocations();
+
         unsigned int m_id;
+        std::unordered_map<std::string, int> m_uniformLocations;
     };
 
 } // namespace renderer
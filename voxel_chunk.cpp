@@ -1,73 +1,343 @@
 #include "voxel_chunk.h"
-#include "renderer.h"
-#include "camera.h"
-#include "mesh.h"
-#include <glm/gtc/matrix_transform.hpp>
+#include "chunk_mesher.h"
+#include "linear_arena.h"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <iostream>
 
 namespace voxel {
 
-    VoxelChunk::VoxelChunk(int chunkX, int chunkY, int chunkZ, int size)
+    const int VoxelChunk::NEIGHBOR_OFFSETS[6][3] = {
+        { 0, 0, -1 }, { 0, 0, 1 }, { -1, 0, 0 }, { 1, 0, 0 }, { 0, -1, 0 }, { 0, 1, 0 }
+    };
+
+    namespace {
+
+        typedef WorldChunkShape Shape;
+
+        const int BRICK_SHIFT = 2;
+        const int BRICK_MASK = (1 << BRICK_SHIFT) - 1;
+        // Bricks per chunk along X and Y as shifts
+        const int BRICKS_SHIFT_X = Shape::SHIFT_X - BRICK_SHIFT;
+        const int BRICKS_SHIFT_Y = Shape::SHIFT_Y - BRICK_SHIFT;
+
+        // Morton order interleaves X, Y and Z within cubes of SIZE_X
+        const bool MORTON_SUPPORTED = Shape::SHIFT_X == Shape::SHIFT_Z && Shape::SHIFT_X <= Shape::SHIFT_Y;
+
+        // Spreads the low 10 bits of v so two zero bits follow each one (Morton encoding)
+        unsigned int spreadBits(unsigned int v) {
+            v = (v | (v << 16)) & 0x030000FF;
+            v = (v | (v << 8)) & 0x0300F00F;
+            v = (v | (v << 4)) & 0x030C30C3;
+            v = (v | (v << 2)) & 0x09249249;
+            return v;
+        }
+
+        // Inverse of spreadBits, gathers every third bit
+        unsigned int compactBits(unsigned int v) {
+            v &= 0x09249249;
+            v = (v | (v >> 2)) & 0x030C30C3;
+            v = (v | (v >> 4)) & 0x0300F00F;
+            v = (v | (v >> 8)) & 0x030000FF;
+            v = (v | (v >> 16)) & 0x000003FF;
+            return v;
+        }
+
+    } // namespace
+
+    VoxelChunk::VoxelChunk(int chunkX, int chunkY, int chunkZ, ChunkPools* pools,
+        DirtyChunkList* dirtyList)
         : m_chunkX(chunkX)
         , m_chunkY(chunkY)
         , m_chunkZ(chunkZ)
-        , m_size(size)
-        , m_mesh(nullptr)
-        , m_dirty(true)
+        , m_layout(VoxelLayout::LINEAR)
+        , m_pools(pools)
+        , m_rows(nullptr)
+        , m_uniformSolid(false)
+        , m_solidCount(0)
+        , m_materials(Shape::VOLUME)
+        , m_dirtySections(ChunkMesher::ALL_SECTIONS)
+        , m_immediate(false)
+        , m_dirtyList(dirtyList)
+        , m_inDirtyList(false)
+        , m_meshInFlight(false)
+        , m_inFlightRevision(0)
+        , m_inFlightSections(0)
+        , m_meshingMode(MeshingMode::GREEDY)
+        , m_meshRevision(0)
+        , m_appliedRevision(0)
+        , m_meshMin{ 0, 0, 0 }
+        , m_meshMax{ -1, -1, -1 }
+        , m_cullSlot(-1)
     {
-        // Initialize voxel data
-        m_voxels.resize(size * size * size, false);
+        for (auto& neighbor : m_neighbors) {
+            neighbor = nullptr;
+        }
+
+        m_countX.fill(0);
+        m_countY.fill(0);
+        m_countZ.fill(0);
+
+        // New chunks need their first mesh
+        addToDirtyList();
+
+        // Chunks start out uniformly empty, rows (one mask per (y, z) line) are allocated on demand
     }
 
     VoxelChunk::~VoxelChunk() {
-        if (m_mesh) {
-            delete m_mesh;
+        // Unlink from the neighbours so they never see a dangling pointer
+        for (int face = 0; face < 6; face++) {
+            if (m_neighbors[face]) {
+                m_neighbors[face]->setNeighbor(face ^ 1, nullptr);
+            }
         }
+
+        releaseRows();
+        releaseMesh();
     }
 
-    void VoxelChunk::update(float deltaTime) {
-        // Rebuild mesh if dirty
-        if (m_dirty) {
-            rebuildMesh();
-            m_dirty = false;
+    bool VoxelChunk::getDraw(renderer::ChunkDraw& draw) const {
+        if (!m_geometry.isValid()) return false;
+
+        // Chunk origin in world space, vertices are chunk-local
+        draw.range = m_geometry;
+        draw.origin = glm::vec3(m_chunkX * SIZE_X, m_chunkY * SIZE_Y, m_chunkZ * SIZE_Z);
+
+        glm::vec3 min, max;
+        if (getMeshBounds(min, max)) {
+            draw.center = (min + max) * 0.5f;
         }
+        else {
+            draw.center = draw.origin + glm::vec3(SIZE_X, SIZE_Y, SIZE_Z) * 0.5f;
+        }
+        return true;
     }
 
-    void VoxelChunk::render(renderer::Renderer* renderer, renderer::Camera* camera) {
-        if (!renderer || !camera || !m_mesh) return;
+    bool VoxelChunk::setVoxel(int x, int y, int z, bool value) {
+        if (!Shape::contains(x, y, z)) {
+            return false;
+        }
 
-        // Calculate model matrix
-        glm::mat4 model = glm::translate(
-            glm::mat4(1.0f),
-            glm::vec3(m_chunkX * m_size, m_chunkY * m_size, m_chunkZ * m_size)
-        );
+        if (value == hasVoxel(x, y, z)) return false;
 
-        // Draw mesh with a more vibrant color
-        renderer->drawMesh(m_mesh, model, glm::vec3(0.9f, 0.5f, 0.2f));
+        return setMaterial(x, y, z, value ? DEFAULT_MATERIAL : AIR_MATERIAL);
     }
 
-    bool VoxelChunk::setVoxel(int x, int y, int z, bool value) {
-        if (x < 0 || y < 0 || z < 0 || x >= m_size || y >= m_size || z >= m_size) {
+    bool VoxelChunk::setMaterial(int x, int y, int z, MaterialId material) {
+        if (!writeMaterial(x, y, z, material)) return false;
+
+        markSectionsDirty(getAffectedSections(y));
+        return true;
+    }
+
+    bool VoxelChunk::writeMaterial(int x, int y, int z, MaterialId material) {
+        if (!Shape::contains(x, y, z)) {
             return false;
         }
 
-        int index = (z * m_size * m_size) + (y * m_size) + x;
+        MaterialId previous = m_materials.set(getVoxelIndex(x, y, z), material);
+        if (previous == material) return false;
+
+        // Occupancy only changes when the voxel turns solid or empty
+        if ((previous != AIR_MATERIAL) != (material != AIR_MATERIAL)) {
+            updateRowOccupancy(y, z, RowMask(1) << x, material != AIR_MATERIAL);
+        }
+
+        return true;
+    }
+
+    MaterialId VoxelChunk::getMaterial(int x, int y, int z) const {
+        if (!Shape::contains(x, y, z)) {
+            return AIR_MATERIAL;
+        }
 
-        if (m_voxels[index] != value) {
-            m_voxels[index] = value;
-            m_dirty = true;
+        return m_materials.get(getVoxelIndex(x, y, z));
+    }
+
+    bool VoxelChunk::containsMaterial(MaterialId material) const {
+        return m_materials.contains(material);
+    }
+
+    const PaletteStorage& VoxelChunk::getMaterials() const {
+        return m_materials;
+    }
+
+    RowMask VoxelChunk::setRowMaterial(int y, int z, RowMask mask, MaterialId material) {
+        mask &= getFullRow();
+
+        RowMask changed = 0;
+        while (mask) {
+            int x = std::countr_zero(mask);
+            mask &= mask - 1;
+
+            if (m_materials.set(getVoxelIndex(x, y, z), material) != material) {
+                changed |= RowMask(1) << x;
+            }
+        }
+
+        if (changed) {
+            updateRowOccupancy(y, z, changed, material != AIR_MATERIAL);
+        }
+
+        return changed;
+    }
+
+    RowMask VoxelChunk::replaceRowMaterial(int y, int z, RowMask mask, MaterialId from, MaterialId to) {
+        mask &= getFullRow();
+        if (from == to) return 0;
+
+        RowMask changed = 0;
+        while (mask) {
+            int x = std::countr_zero(mask);
+            mask &= mask - 1;
+
+            int index = getVoxelIndex(x, y, z);
+            if (m_materials.get(index) == from) {
+                m_materials.set(index, to);
+                changed |= RowMask(1) << x;
+            }
+        }
+
+        if (changed) {
+            updateRowOccupancy(y, z, changed, to != AIR_MATERIAL);
+        }
+
+        return changed;
+    }
+
+    bool VoxelChunk::setVoxelLayout(VoxelLayout layout) {
+        if (layout == m_layout) return true;
+
+        if (layout == VoxelLayout::MORTON && !MORTON_SUPPORTED) {
+            std::cerr << "Morton voxel layout needs chunks with equal X and Z no taller than Y" << std::endl;
+            return false;
+        }
+
+        // A uniform palette has no per-voxel data to move
+        bool mixed = false;
+        MaterialId uniform = m_materials.getUniformMaterial(mixed);
+        if (!mixed) {
+            m_layout = layout;
+            m_materials.fill(uniform);
             return true;
         }
 
-        return false;
+        std::vector<MaterialId> decoded(Shape::VOLUME);
+        m_materials.decode(decoded.data());
+
+        PaletteStorage materials(Shape::VOLUME);
+        for (int index = 0; index < Shape::VOLUME; index++) {
+            int x, y, z;
+            getVoxelPosition(index, x, y, z);
+            materials.set(getVoxelIndex(layout, x, y, z), decoded[index]);
+        }
+
+        m_layout = layout;
+        m_materials = std::move(materials);
+        return true;
+    }
+
+    VoxelLayout VoxelChunk::getVoxelLayout() const {
+        return m_layout;
+    }
+
+    int VoxelChunk::getVoxelIndex(int x, int y, int z) const {
+        return getVoxelIndex(m_layout, x, y, z);
+    }
+
+    int VoxelChunk::getVoxelIndex(VoxelLayout layout, int x, int y, int z) const {
+        switch (layout) {
+        case VoxelLayout::MORTON: {
+            // Z-ordered cubes of SIZE_X, stacked along Y for column chunks
+            int cube = y >> Shape::SHIFT_X;
+            int local = static_cast<int>(spreadBits(x) | (spreadBits(y & Shape::MASK_X) << 1) | (spreadBits(z) << 2));
+            return (cube << (3 * Shape::SHIFT_X)) | local;
+        }
+        case VoxelLayout::BRICK: {
+            int brick = (((z >> BRICK_SHIFT) << BRICKS_SHIFT_Y | (y >> BRICK_SHIFT)) << BRICKS_SHIFT_X) |
+                (x >> BRICK_SHIFT);
+            int local = (((z & BRICK_MASK) << BRICK_SHIFT | (y & BRICK_MASK)) << BRICK_SHIFT) | (x & BRICK_MASK);
+            return (brick << (3 * BRICK_SHIFT)) | local;
+        }
+        default:
+            return Shape::getVoxelIndex(x, y, z);
+        }
+    }
+
+    void VoxelChunk::getVoxelPosition(int index, int& x, int& y, int& z) const {
+        switch (m_layout) {
+        case VoxelLayout::MORTON: {
+            int cube = index >> (3 * Shape::SHIFT_X);
+            int local = index & ((1 << (3 * Shape::SHIFT_X)) - 1);
+            x = compactBits(local);
+            y = (cube << Shape::SHIFT_X) | compactBits(local >> 1);
+            z = compactBits(local >> 2);
+            break;
+        }
+        case VoxelLayout::BRICK: {
+            int brick = index >> (3 * BRICK_SHIFT);
+            x = ((brick & ((1 << BRICKS_SHIFT_X) - 1)) << BRICK_SHIFT) | (index & BRICK_MASK);
+            brick >>= BRICKS_SHIFT_X;
+            y = ((brick & ((1 << BRICKS_SHIFT_Y) - 1)) << BRICK_SHIFT) | ((index >> BRICK_SHIFT) & BRICK_MASK);
+            brick >>= BRICKS_SHIFT_Y;
+            z = (brick << BRICK_SHIFT) | ((index >> (2 * BRICK_SHIFT)) & BRICK_MASK);
+            break;
+        }
+        default:
+            x = index & Shape::MASK_X;
+            y = (index >> Shape::SHIFT_X) & Shape::MASK_Y;
+            z = index >> (Shape::SHIFT_X + Shape::SHIFT_Y);
+            break;
+        }
+    }
+
+    int VoxelChunk::fill(MaterialId material) {
+        // Uniform in O(1), the row and material storage are dropped
+        int changed = Shape::VOLUME - m_materials.count(material);
+
+        m_materials.fill(material);
+        releaseRows();
+        m_uniformSolid = material != AIR_MATERIAL;
+        m_solidCount = m_uniformSolid ? Shape::VOLUME : 0;
+
+        m_countX.fill(m_uniformSolid ? SIZE_Y * SIZE_Z : 0);
+        m_countY.fill(m_uniformSolid ? SIZE_X * SIZE_Z : 0);
+        m_countZ.fill(m_uniformSolid ? SIZE_X * SIZE_Y : 0);
+
+        return changed;
+    }
+
+    void VoxelChunk::updateRowOccupancy(int y, int z, RowMask changed, bool solid) {
+        // Bits whose occupancy flips
+        RowMask row = isUniform() ? (m_uniformSolid ? getFullRow() : 0) : m_rows[Shape::getRowIndex(y, z)];
+        RowMask flipped = solid ? (changed & ~row) : (changed & row);
+
+        if (flipped) {
+            materialize();
+            m_rows[Shape::getRowIndex(y, z)] ^= flipped;
+
+            int delta = solid ? 1 : -1;
+            int count = std::popcount(flipped);
+            m_solidCount += delta * count;
+            m_countY[y] += delta * count;
+            m_countZ[z] += delta * count;
+            for (RowMask bits = flipped; bits; bits &= bits - 1) {
+                m_countX[std::countr_zero(bits)] += delta;
+            }
+
+            collapseIfUniform();
+        }
     }
 
     bool VoxelChunk::hasVoxel(int x, int y, int z) const {
-        if (x < 0 || y < 0 || z < 0 || x >= m_size || y >= m_size || z >= m_size) {
+        if (!Shape::contains(x, y, z)) {
             return false;
         }
 
-        int index = (z * m_size * m_size) + (y * m_size) + x;
-        return m_voxels[index];
+        if (isUniform()) return m_uniformSolid;
+
+        return (m_rows[Shape::getRowIndex(y, z)] >> x) & 1;
     }
 
     bool VoxelChunk::isVoxelVisible(int x, int y, int z) const {
@@ -97,140 +367,471 @@ namespace voxel {
         return m_chunkZ;
     }
 
-    int VoxelChunk::getSize() const {
-        return m_size;
+    VoxelChunk* VoxelChunk::getNeighbor(int face) const {
+        return m_neighbors[face];
+    }
+
+    void VoxelChunk::setNeighbor(int face, VoxelChunk* neighbor) {
+        m_neighbors[face] = neighbor;
+    }
+
+    unsigned int VoxelChunk::getAffectedSections(int y) const {
+        // Faces of the voxels above and below change too
+        unsigned int sections = ChunkMesher::getSection(y);
+        if (y > 0) sections |= ChunkMesher::getSection(y - 1);
+        if (y < SIZE_Y - 1) sections |= ChunkMesher::getSection(y + 1);
+        return sections;
+    }
+
+    bool VoxelChunk::isUniform() const {
+        return m_rows == nullptr;
+    }
+
+    bool VoxelChunk::isEmpty() const {
+        return m_solidCount == 0;
+    }
+
+    bool VoxelChunk::isFull() const {
+        return m_solidCount == Shape::VOLUME;
+    }
+
+    int VoxelChunk::getSolidCount() const {
+        return m_solidCount;
+    }
+
+    bool VoxelChunk::getBounds(VoxelPos& min, VoxelPos& max) const {
+        if (isEmpty()) return false;
+
+        // First and last non-empty plane along each axis
+        auto findRange = [](const auto& counts, int& first, int& last) {
+            first = 0;
+            last = static_cast<int>(counts.size()) - 1;
+            while (counts[first] == 0) first++;
+            while (counts[last] == 0) last--;
+        };
+
+        findRange(m_countX, min.x, max.x);
+        findRange(m_countY, min.y, max.y);
+        findRange(m_countZ, min.z, max.z);
+        return true;
+    }
+
+    bool VoxelChunk::getMeshBounds(glm::vec3& min, glm::vec3& max) const {
+        if (!m_geometry.isValid() || m_meshMin.x > m_meshMax.x) return false;
+
+        glm::vec3 origin(m_chunkX * SIZE_X, m_chunkY * SIZE_Y, m_chunkZ * SIZE_Z);
+        min = origin + glm::vec3(m_meshMin.x, m_meshMin.y, m_meshMin.z);
+        max = origin + glm::vec3(m_meshMax.x, m_meshMax.y, m_meshMax.z) + 1.0f;
+        return true;
+    }
+
+    int VoxelChunk::getCullSlot() const {
+        return m_cullSlot;
+    }
+
+    void VoxelChunk::setCullSlot(int slot) {
+        m_cullSlot = slot;
+    }
+
+    const RowMask* VoxelChunk::getRows() const {
+        return m_rows;
+    }
+
+    RowMask VoxelChunk::getFullRow() const {
+        return SIZE_X == 64 ? ~RowMask(0) : (RowMask(1) << SIZE_X) - 1;
+    }
+
+    void VoxelChunk::materialize() {
+        if (!isUniform()) return;
+
+        m_rows = m_pools ? static_cast<RowMask*>(m_pools->rows.allocate()) : new RowMask[Shape::ROW_COUNT];
+        std::fill(m_rows, m_rows + Shape::ROW_COUNT, m_uniformSolid ? getFullRow() : 0);
+    }
+
+    void VoxelChunk::collapseIfUniform() {
+        if (isUniform() || !(isEmpty() || isFull())) return;
+
+        releaseRows();
+        m_uniformSolid = isFull();
     }
 
-    void VoxelChunk::rebuildMesh() {
-        // Clean up old mesh
-        if (m_mesh) {
-            delete m_mesh;
-            m_mesh = nullptr;
+    void VoxelChunk::releaseRows() {
+        if (!m_rows) return;
+
+        if (m_pools) {
+            m_pools->rows.release(m_rows);
+        }
+        else {
+            delete[] m_rows;
         }
+        m_rows = nullptr;
+    }
 
-        // Create new mesh
-        std::vector<float> vertices;
-        std::vector<unsigned int> indices;
+    void VoxelChunk::releaseMesh() {
+        if (m_pools) {
+            m_pools->geometry.release(m_geometry);
+        }
+    }
 
-        // Add faces for each visible voxel
-        for (int z = 0; z < m_size; z++) {
-            for (int y = 0; y < m_size; y++) {
-                for (int x = 0; x < m_size; x++) {
-                    if (hasVoxel(x, y, z)) {
-                        // Add faces that are not occluded
-                        if (!hasVoxel(x, y, z - 1)) { // Front face
-                            createCubeFace(vertices, indices, x, y, z, 0);
-                        }
-                        if (!hasVoxel(x, y, z + 1)) { // Back face
-                            createCubeFace(vertices, indices, x, y, z, 1);
-                        }
-                        if (!hasVoxel(x - 1, y, z)) { // Left face
-                            createCubeFace(vertices, indices, x, y, z, 2);
-                        }
-                        if (!hasVoxel(x + 1, y, z)) { // Right face
-                            createCubeFace(vertices, indices, x, y, z, 3);
-                        }
-                        if (!hasVoxel(x, y - 1, z)) { // Bottom face
-                            createCubeFace(vertices, indices, x, y, z, 4);
+    void VoxelChunk::setMeshingMode(MeshingMode mode) {
+        if (m_meshingMode != mode) {
+            m_meshingMode = mode;
+            markDirty();
+        }
+    }
+
+    MeshingMode VoxelChunk::getMeshingMode() const {
+        return m_meshingMode;
+    }
+
+    bool VoxelChunk::isDirty() const {
+        return m_dirtySections != 0;
+    }
+
+    void VoxelChunk::markDirty(bool immediate) {
+        m_dirtySections = ChunkMesher::ALL_SECTIONS;
+        m_immediate = m_immediate || immediate;
+        addToDirtyList();
+    }
+
+    void VoxelChunk::markSectionDirty(int y, bool immediate) {
+        markSectionsDirty(ChunkMesher::getSection(y), immediate);
+    }
+
+    void VoxelChunk::markSectionsDirty(unsigned int sections, bool immediate) {
+        if (sections == 0) return;
+
+        m_dirtySections |= sections;
+        m_immediate = m_immediate || immediate;
+        addToDirtyList();
+    }
+
+    bool VoxelChunk::needsImmediateRemesh() const {
+        return m_dirtySections != 0 && m_immediate;
+    }
+
+    bool VoxelChunk::isInDirtyList() const {
+        return m_inDirtyList;
+    }
+
+    void VoxelChunk::setInDirtyList(bool listed) {
+        m_inDirtyList = listed;
+    }
+
+    void VoxelChunk::addToDirtyList() {
+        if (m_dirtyList && !m_inDirtyList) {
+            m_dirtyList->push_back(this);
+            m_inDirtyList = true;
+        }
+    }
+
+    bool VoxelChunk::isMeshInFlight() const {
+        return m_meshInFlight;
+    }
+
+    unsigned int VoxelChunk::createMeshInput(ChunkMeshInput& input, bool async, const MaterialTable& materialTable) {
+        unsigned int sections = m_dirtySections;
+
+        // The first mesh lays out every section
+        if (m_sections.empty()) {
+            sections = ChunkMesher::ALL_SECTIONS;
+        }
+
+        // A snapshot taken while a worker is busy supersedes its job, so it has to cover
+        // the sections that job would have updated
+        if (m_meshInFlight) {
+            sections |= m_inFlightSections;
+        }
+
+        input.mode = m_meshingMode;
+        input.sections = sections;
+        if (!getBounds(input.boundsMin, input.boundsMax)) {
+            input.boundsMin = { 0, 0, 0 };
+            input.boundsMax = { -1, -1, -1 };
+        }
+        if (isUniform()) {
+            input.rows.assign(Shape::ROW_COUNT, m_uniformSolid ? getFullRow() : 0);
+        }
+        else {
+            input.rows.assign(m_rows, m_rows + Shape::ROW_COUNT);
+        }
+
+        engine::LinearArena& arena = engine::getFrameArena();
+        engine::ArenaScope scope(arena);
+
+        // Solid materials in use; a single one is passed as is, several are decoded in bulk
+        engine::ArenaVector<MaterialId> materials{ engine::ArenaAllocator<MaterialId>(arena) };
+        materials.reserve(m_materials.getPalette().size());
+        m_materials.getMaterials(materials);
+        materials.erase(std::remove(materials.begin(), materials.end(), AIR_MATERIAL), materials.end());
+
+        bool transparent = false;
+        for (MaterialId material : materials) {
+            transparent = transparent || materialTable.isTransparent(material);
+        }
+
+        if (materials.size() <= 1) {
+            input.singleMaterial = materials.empty() ? DEFAULT_MATERIAL : materials[0];
+            input.materials.clear();
+        }
+        else {
+            input.materials.resize(Shape::VOLUME);
+
+            // The mesher reads materials in linear order
+            if (m_layout == VoxelLayout::LINEAR) {
+                m_materials.decode(input.materials.data());
+            }
+            else {
+                MaterialId* decoded = arena.allocateArray<MaterialId>(Shape::VOLUME);
+                m_materials.decode(decoded);
+
+                int index = 0;
+                for (int z = 0; z < SIZE_Z; z++) {
+                    for (int y = 0; y < SIZE_Y; y++) {
+                        for (int x = 0; x < SIZE_X; x++) {
+                            input.materials[index++] = decoded[getVoxelIndex(x, y, z)];
                         }
-                        if (!hasVoxel(x, y + 1, z)) { // Top face
-                            createCubeFace(vertices, indices, x, y, z, 5);
+                    }
+                }
+            }
+        }
+
+        // Opaque voxels only matter once the chunk holds transparent ones
+        input.opaqueRows.clear();
+        if (transparent) {
+            input.opaqueRows.assign(Shape::ROW_COUNT, 0);
+
+            if (!input.materials.empty()) {
+                for (int row = 0; row < Shape::ROW_COUNT; row++) {
+                    RowMask bits = input.rows[row];
+                    while (bits) {
+                        int x = std::countr_zero(bits);
+                        bits &= bits - 1;
+
+                        if (!materialTable.isTransparent(input.materials[(row << Shape::SHIFT_X) | x])) {
+                            input.opaqueRows[row] |= RowMask(1) << x;
                         }
                     }
                 }
             }
         }
 
-        // Create mesh if there are any vertices
-        if (!vertices.empty()) {
-            m_mesh = new renderer::Mesh();
-            m_mesh->setVertices(vertices, indices);
-        }
-    }
-
-    void VoxelChunk::createCubeFace(std::vector<float>& vertices, std::vector<unsigned int>& indices,
-        int x, int y, int z, int faceIndex) {
-        // Define the 8 vertices of the cube
-        glm::vec3 v0(x, y, z);
-        glm::vec3 v1(x + 1, y, z);
-        glm::vec3 v2(x + 1, y + 1, z);
-        glm::vec3 v3(x, y + 1, z);
-        glm::vec3 v4(x, y, z + 1);
-        glm::vec3 v5(x + 1, y, z + 1);
-        glm::vec3 v6(x + 1, y + 1, z + 1);
-        glm::vec3 v7(x, y + 1, z + 1);
-
-        // Define normals for each face
-        glm::vec3 normals[] = {
-            glm::vec3(0.0f, 0.0f, -1.0f), // Front
-            glm::vec3(0.0f, 0.0f, 1.0f),  // Back
-            glm::vec3(-1.0f, 0.0f, 0.0f), // Left
-            glm::vec3(1.0f, 0.0f, 0.0f),  // Right
-            glm::vec3(0.0f, -1.0f, 0.0f), // Bottom
-            glm::vec3(0.0f, 1.0f, 0.0f)   // Top
-        };
+        for (auto& neighbor : input.neighbors) {
+            neighbor.clear();
+        }
+        for (auto& neighbor : input.neighborMaterials) {
+            neighbor.clear();
+        }
 
-        // Get the current vertex count
-        unsigned int baseIndex = vertices.size() / 6;
-
-        // Add vertices and indices for the selected face
-        switch (faceIndex) {
-        case 0: // Front face (negative z)
-            vertices.insert(vertices.end(), {
-                v0.x, v0.y, v0.z, normals[0].x, normals[0].y, normals[0].z,
-                v1.x, v1.y, v1.z, normals[0].x, normals[0].y, normals[0].z,
-                v2.x, v2.y, v2.z, normals[0].x, normals[0].y, normals[0].z,
-                v3.x, v3.y, v3.z, normals[0].x, normals[0].y, normals[0].z
-                });
+        m_dirtySections = 0;
+        m_immediate = false;
+
+        unsigned int revision = ++m_meshRevision;
+        if (async) {
+            m_meshInFlight = true;
+            m_inFlightRevision = revision;
+            m_inFlightSections = sections;
+        }
+
+        return revision;
+    }
+
+    void VoxelChunk::copyBoundarySlice(int face, std::vector<RowMask>& slice, const MaterialTable& materialTable) const {
+        // Transparent voxels do not hide the faces behind them
+        int rows = ChunkMesher::getPlaneRows(face);
+        if (hasTransparentMaterials(materialTable)) {
+            slice.assign(rows, 0);
+            for (int v = 0; v < rows; v++) {
+                for (int u = 0; u < ChunkMesher::getPlaneWidth(face); u++) {
+                    int x, y, z;
+                    getBoundaryVoxel(face, u, v, x, y, z);
+
+                    MaterialId material = getMaterial(x, y, z);
+                    if (material != AIR_MATERIAL && !materialTable.isTransparent(material)) {
+                        slice[v] |= RowMask(1) << u;
+                    }
+                }
+            }
+            return;
+        }
+
+        if (isUniform()) {
+            RowMask fullRow = (ChunkMesher::getPlaneWidth(face) == 64) ? ~RowMask(0) :
+                (RowMask(1) << ChunkMesher::getPlaneWidth(face)) - 1;
+            slice.assign(rows, m_uniformSolid ? fullRow : 0);
+            return;
+        }
+
+        slice.assign(rows, 0);
+
+        switch (face) {
+        case 0: // Front (z = 0), rows by y
+            for (int y = 0; y < SIZE_Y; y++) slice[y] = m_rows[Shape::getRowIndex(y, 0)];
             break;
-        case 1: // Back face (positive z)
-            vertices.insert(vertices.end(), {
-                v4.x, v4.y, v4.z, normals[1].x, normals[1].y, normals[1].z,
-                v7.x, v7.y, v7.z, normals[1].x, normals[1].y, normals[1].z,
-                v6.x, v6.y, v6.z, normals[1].x, normals[1].y, normals[1].z,
-                v5.x, v5.y, v5.z, normals[1].x, normals[1].y, normals[1].z
-                });
+        case 1: // Back (z = SIZE_Z - 1), rows by y
+            for (int y = 0; y < SIZE_Y; y++) slice[y] = m_rows[Shape::getRowIndex(y, SIZE_Z - 1)];
             break;
-        case 2: // Left face (negative x)
-            vertices.insert(vertices.end(), {
-                v0.x, v0.y, v0.z, normals[2].x, normals[2].y, normals[2].z,
-                v3.x, v3.y, v3.z, normals[2].x, normals[2].y, normals[2].z,
-                v7.x, v7.y, v7.z, normals[2].x, normals[2].y, normals[2].z,
-                v4.x, v4.y, v4.z, normals[2].x, normals[2].y, normals[2].z
-                });
+        case 2: // Left (x = 0), rows by y with bit z
+            for (int z = 0; z < SIZE_Z; z++) {
+                for (int y = 0; y < SIZE_Y; y++) {
+                    slice[y] |= (m_rows[Shape::getRowIndex(y, z)] & 1) << z;
+                }
+            }
             break;
-        case 3: // Right face (positive x)
-            vertices.insert(vertices.end(), {
-                v1.x, v1.y, v1.z, normals[3].x, normals[3].y, normals[3].z,
-                v5.x, v5.y, v5.z, normals[3].x, normals[3].y, normals[3].z,
-                v6.x, v6.y, v6.z, normals[3].x, normals[3].y, normals[3].z,
-                v2.x, v2.y, v2.z, normals[3].x, normals[3].y, normals[3].z
-                });
+        case 3: // Right (x = SIZE_X - 1), rows by y with bit z
+            for (int z = 0; z < SIZE_Z; z++) {
+                for (int y = 0; y < SIZE_Y; y++) {
+                    slice[y] |= ((m_rows[Shape::getRowIndex(y, z)] >> (SIZE_X - 1)) & 1) << z;
+                }
+            }
             break;
-        case 4: // Bottom face (negative y)
-            vertices.insert(vertices.end(), {
-                v0.x, v0.y, v0.z, normals[4].x, normals[4].y, normals[4].z,
-                v4.x, v4.y, v4.z, normals[4].x, normals[4].y, normals[4].z,
-                v5.x, v5.y, v5.z, normals[4].x, normals[4].y, normals[4].z,
-                v1.x, v1.y, v1.z, normals[4].x, normals[4].y, normals[4].z
-                });
+        case 4: // Bottom (y = 0), rows by z
+            for (int z = 0; z < SIZE_Z; z++) slice[z] = m_rows[Shape::getRowIndex(0, z)];
             break;
-        case 5: // Top face (positive y)
-            vertices.insert(vertices.end(), {
-                v3.x, v3.y, v3.z, normals[5].x, normals[5].y, normals[5].z,
-                v2.x, v2.y, v2.z, normals[5].x, normals[5].y, normals[5].z,
-                v6.x, v6.y, v6.z, normals[5].x, normals[5].y, normals[5].z,
-                v7.x, v7.y, v7.z, normals[5].x, normals[5].y, normals[5].z
-                });
+        case 5: // Top (y = SIZE_Y - 1), rows by z
+            for (int z = 0; z < SIZE_Z; z++) slice[z] = m_rows[Shape::getRowIndex(SIZE_Y - 1, z)];
             break;
         }
+    }
+
+    void VoxelChunk::copyBoundaryMaterials(int face, std::vector<MaterialId>& slice) const {
+        int width = ChunkMesher::getPlaneWidth(face);
+        slice.resize(ChunkMesher::getPlaneRows(face) * width);
 
-        // Add indices for the quad (two triangles)
-        indices.insert(indices.end(), {
-            baseIndex, baseIndex + 1, baseIndex + 2,
-            baseIndex, baseIndex + 2, baseIndex + 3
-            });
+        for (int v = 0; v < ChunkMesher::getPlaneRows(face); v++) {
+            for (int u = 0; u < width; u++) {
+                int x, y, z;
+                getBoundaryVoxel(face, u, v, x, y, z);
+                slice[v * width + u] = getMaterial(x, y, z);
+            }
+        }
     }
 
-} // namespace voxel
+    bool VoxelChunk::hasTransparentMaterials(const MaterialTable& materialTable) const {
+        if (isEmpty()) return false;
+
+        // Stale palette entries at worst send the chunk down the slower exact path
+        for (MaterialId material : m_materials.getPalette()) {
+            if (material != AIR_MATERIAL && materialTable.isTransparent(material)) return true;
+        }
+        return false;
+    }
+
+    void VoxelChunk::getBoundaryVoxel(int face, int u, int v, int& x, int& y, int& z) const {
+        switch (face) {
+        case 0: x = u; y = v; z = 0; break;              // Front, rows by y
+        case 1: x = u; y = v; z = SIZE_Z - 1; break;     // Back, rows by y
+        case 2: x = 0; y = v; z = u; break;              // Left, rows by y with bit z
+        case 3: x = SIZE_X - 1; y = v; z = u; break;     // Right, rows by y with bit z
+        case 4: x = u; y = 0; z = v; break;              // Bottom, rows by z
+        default: x = u; y = SIZE_Y - 1; z = v; break;    // Top, rows by z
+        }
+    }
+
+    bool VoxelChunk::applyMesh(const ChunkMeshOutput& output, unsigned int revision) {
+        if (m_meshInFlight && revision == m_inFlightRevision) {
+            m_meshInFlight = false;
+        }
 
+        if (revision <= m_appliedRevision) return true;
+        m_appliedRevision = revision;
+
+        if (output.sections == ChunkMesher::ALL_SECTIONS) {
+            rebuildMesh(output);
+            m_meshMin = output.boundsMin;
+            m_meshMax = output.boundsMax;
+            return true;
+        }
+
+        // Partial updates must fit the slots of the current layout
+        for (int section = 0; section < static_cast<int>(output.sectionVertices.size()); section++) {
+            if (!(output.sections & (1u << section))) continue;
+
+            unsigned int quadCount = static_cast<unsigned int>(output.sectionVertices[section].size() / 8);
+            if (m_sections.empty() || quadCount > m_sections[section].capacity) {
+                markDirty();
+                return false;
+            }
+        }
+
+        // Overwrite the changed sections in place, padding each slot with degenerate quads
+        engine::LinearArena& arena = engine::getFrameArena();
+        for (int section = 0; section < static_cast<int>(output.sectionVertices.size()); section++) {
+            if (!(output.sections & (1u << section))) continue;
+
+            const std::vector<unsigned int>& vertices = output.sectionVertices[section];
+            MeshSection& layout = m_sections[section];
+            unsigned int quadCount = static_cast<unsigned int>(vertices.size() / 8);
+
+            if (m_geometry.isValid() && (quadCount > 0 || layout.count > 0)) {
+                engine::ArenaScope scope(arena);
+                size_t slotSize = layout.capacity * 8;
+                unsigned int* slot = arena.allocateArray<unsigned int>(slotSize);
+                std::copy(vertices.begin(), vertices.end(), slot);
+                std::fill(slot + vertices.size(), slot + slotSize, 0u);
+                m_pools->geometry.upload(m_geometry, layout.firstQuad, slot, slotSize);
+            }
+            layout.count = quadCount;
+        }
+
+        // Sections left alone hold no voxels outside the new snapshot's bounds either
+        m_meshMin = output.boundsMin;
+        m_meshMax = output.boundsMax;
+        return true;
+    }
+
+    void VoxelChunk::rebuildMesh(const ChunkMeshOutput& output) {
+        // Lay the sections out back to back, each with room to grow
+        m_sections.assign(output.sectionVertices.size(), MeshSection());
+
+        unsigned int totalQuads = 0;
+        unsigned int visibleQuads = 0;
+        for (size_t section = 0; section < m_sections.size(); section++) {
+            unsigned int quadCount = static_cast<unsigned int>(output.sectionVertices[section].size() / 8);
+            m_sections[section].firstQuad = totalQuads;
+            m_sections[section].count = quadCount;
+            m_sections[section].capacity = quadCount + quadCount / 4 + 4;
+            totalQuads += m_sections[section].capacity;
+            visibleQuads += quadCount;
+        }
+
+        // Drop the mesh once the chunk has no visible faces (or nowhere to store them);
+        // zero capacity slots make the next face that appears trigger a rebuild
+        if (visibleQuads == 0 || !m_pools) {
+            for (auto& layout : m_sections) {
+                layout.capacity = 0;
+            }
+
+            releaseMesh();
+            return;
+        }
+
+        // Staged in the frame arena; slack at the end of each slot is degenerate quads
+        engine::LinearArena& arena = engine::getFrameArena();
+        engine::ArenaScope scope(arena);
+        size_t vertexCount = totalQuads * 8;
+        unsigned int* vertices = arena.allocateArray<unsigned int>(vertexCount);
+        std::fill(vertices, vertices + vertexCount, 0u);
+        for (size_t section = 0; section < m_sections.size(); section++) {
+            const std::vector<unsigned int>& sectionVertices = output.sectionVertices[section];
+            std::copy(sectionVertices.begin(), sectionVertices.end(),
+                vertices + m_sections[section].firstQuad * 8);
+        }
+
+        // The new range is filled before the old one is given back
+        renderer::GeometryRange range;
+        if (!m_pools->geometry.allocate(totalQuads, range)) {
+            for (auto& layout : m_sections) {
+                layout.capacity = 0;
+            }
+
+            releaseMesh();
+            return;
+        }
+
+        m_pools->geometry.upload(range, 0, vertices, vertexCount);
+        releaseMesh();
+        m_geometry = range;
+    }
+
+} // namespace voxel
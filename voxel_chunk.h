@@ -1,52 +1,236 @@
 #pragma once
 
+#include "voxel_system.h"
+#include "palette_storage.h"
+#include "block_pool.h"
+#include "chunk_geometry_arena.h"
+#include <array>
 #include <vector>
 #include <glm/glm.hpp>
 
-namespace renderer {
-    class Renderer;
-    class Camera;
-    class Mesh;
-}
-
 namespace voxel {
 
+    struct ChunkMeshInput;
+    struct ChunkMeshOutput;
+    class VoxelChunk;
+
+    // Chunks with dirty sections, each listed once, in the order they became dirty.
+    // Chunks add themselves when marked dirty; the world takes them off once remeshed.
+    typedef std::vector<VoxelChunk*> DirtyChunkList;
+
+    // Storage shared by the chunks of one world: blocks for the occupancy rows and the
+    // GPU arena holding every chunk mesh. Chunks created without them keep their rows on
+    // the heap and have no GPU geometry.
+    struct ChunkPools {
+        BlockPool rows{ sizeof(RowMask) * WorldChunkShape::ROW_COUNT, alignof(RowMask), 64 };
+        renderer::ChunkGeometryArena geometry;
+    };
+
     class VoxelChunk {
     public:
-        VoxelChunk(int chunkX, int chunkY, int chunkZ, int size);
+        typedef WorldChunkShape Shape;
+        static constexpr int SIZE_X = Shape::SIZE_X;
+        static constexpr int SIZE_Y = Shape::SIZE_Y;
+        static constexpr int SIZE_Z = Shape::SIZE_Z;
+
+        VoxelChunk(int chunkX, int chunkY, int chunkZ, ChunkPools* pools = nullptr,
+            DirtyChunkList* dirtyList = nullptr);
         ~VoxelChunk();
 
-        void update(float deltaTime);
-        void render(renderer::Renderer* renderer, renderer::Camera* camera);
+        VoxelChunk(const VoxelChunk&) = delete;
+        VoxelChunk& operator=(const VoxelChunk&) = delete;
 
-        // Voxel manipulation
+        // Range and origin to draw this chunk with, false while it has no geometry
+        bool getDraw(renderer::ChunkDraw& draw) const;
+
+        // Voxel manipulation. Adding a voxel that is already solid keeps its material.
         bool setVoxel(int x, int y, int z, bool value);
         bool hasVoxel(int x, int y, int z) const;
         bool isVoxelVisible(int x, int y, int z) const;
 
+        // Materials, AIR_MATERIAL removes the voxel. Returns true if the voxel changed.
+        bool setMaterial(int x, int y, int z, MaterialId material);
+        // Same write without marking sections dirty, for batches that mark the sections
+        // they touched once when done
+        bool writeMaterial(int x, int y, int z, MaterialId material);
+        MaterialId getMaterial(int x, int y, int z) const;
+        bool containsMaterial(MaterialId material) const;
+        const PaletteStorage& getMaterials() const;
+
+        // Bulk writes. Like writeMaterial they leave marking sections dirty to the caller,
+        // which also knows the neighbours the change touches.
+        //
+        // Writes material to the voxels of mask in row (y, z). Returns the bits that changed.
+        RowMask setRowMaterial(int y, int z, RowMask mask, MaterialId material);
+        // Changes the voxels of mask in row (y, z) that have material from to material to
+        RowMask replaceRowMaterial(int y, int z, RowMask mask, MaterialId from, MaterialId to);
+        // Sets every voxel to material. Returns the number of voxels that changed.
+        int fill(MaterialId material);
+
+        // Per-voxel storage order. Changing it re-encodes the materials. Morton order needs
+        // equal X and Z extents no larger than Y.
+        bool setVoxelLayout(VoxelLayout layout);
+        VoxelLayout getVoxelLayout() const;
+
+        // Storage index of a voxel in the current layout, and back
+        int getVoxelIndex(int x, int y, int z) const;
+        void getVoxelPosition(int index, int& x, int& y, int& z) const;
+
+        // Calls function(x, y, z, material) for every solid voxel, walking the storage
+        // in order so neighbouring calls touch neighbouring memory
+        template <typename Function>
+        void forEachSolidVoxel(Function&& function) const;
+
         // Chunk properties
         int getChunkX() const;
         int getChunkY() const;
         int getChunkZ() const;
-        int getSize() const;
+
+        // Adjacent chunks by face (see FaceDirection), nullptr when not loaded.
+        // Maintained by the world as chunks are created and destroyed.
+        VoxelChunk* getNeighbor(int face) const;
+        void setNeighbor(int face, VoxelChunk* neighbor);
+
+        // Chunk coordinate offset of the neighbour across each face
+        static const int NEIGHBOR_OFFSETS[6][3];
+
+        // Bit mask of the sections whose mesh changes when voxel row y is edited
+        unsigned int getAffectedSections(int y) const;
+
+        // Chunks that are all empty or all solid keep no per-voxel storage. Rows are
+        // allocated on the first write that breaks uniformity and released again as
+        // soon as the chunk becomes uniform.
+        bool isUniform() const;
+        bool isEmpty() const;
+        bool isFull() const;
+        int getSolidCount() const;
+
+        // Tight local bounds of the solid voxels (inclusive), false when the chunk is empty.
+        // Kept up to date by every write, the query only scans the per-plane counts.
+        bool getBounds(VoxelPos& min, VoxelPos& max) const;
+        // World-space box around the current mesh, false while there is nothing to draw.
+        // Follows the voxels the mesh was built from, not later edits.
+        bool getMeshBounds(glm::vec3& min, glm::vec3& max) const;
+        // Entry in the world's ChunkCuller, -1 when not registered
+        int getCullSlot() const;
+        void setCullSlot(int slot);
+
+        // Occupancy rows, indexed Shape::getRowIndex(y, z) with bit x set for solid voxels.
+        // nullptr while the chunk is uniform.
+        const RowMask* getRows() const;
+
+        // Meshing
+        void setMeshingMode(MeshingMode mode);
+        MeshingMode getMeshingMode() const;
+        bool isDirty() const;
+        // Immediate chunks skip the remesh budget and are meshed in the same frame.
+        // markDirty() remeshes every section, markSectionDirty() only the one holding y
+        // and markSectionsDirty() those set in a section bit mask.
+        void markDirty(bool immediate = false);
+        void markSectionDirty(int y, bool immediate = false);
+        void markSectionsDirty(unsigned int sections, bool immediate = false);
+        bool needsImmediateRemesh() const;
+        // True while the chunk is on its dirty list, the list owner clears it on removal
+        bool isInDirtyList() const;
+        void setInDirtyList(bool listed);
+
+        // True while a worker is meshing this chunk; only one job per chunk is in flight
+        // so section updates are applied in order
+        bool isMeshInFlight() const;
+
+        // Copies the voxel data and the dirty sections into a mesher snapshot and clears
+        // the dirty flags. Neighbour slices are filled in by the world. Returns the
+        // snapshot's revision.
+        unsigned int createMeshInput(ChunkMeshInput& input, bool async, const MaterialTable& materialTable);
+
+        // Copies the opaque voxels on the given face of this chunk in mesher plane layout
+        void copyBoundarySlice(int face, std::vector<RowMask>& slice, const MaterialTable& materialTable) const;
+        // Copies the materials on the given face, indexed v * width + u in plane layout
+        void copyBoundaryMaterials(int face, std::vector<MaterialId>& slice) const;
+        bool hasTransparentMaterials(const MaterialTable& materialTable) const;
+
+        // Uploads finished sections into the chunk's vertex buffer in place. Results older
+        // than the mesh already shown are ignored. Returns false if a section outgrew its
+        // slot (or there is no buffer yet); the whole chunk is then marked dirty so it
+        // gets rebuilt with a fresh layout.
+        bool applyMesh(const ChunkMeshOutput& output, unsigned int revision);
 
     private:
-        void rebuildMesh();
-        void createCubeFace(std::vector<float>& vertices, std::vector<unsigned int>& indices,
-            int x, int y, int z, int faceIndex);
+        // Quad range of one section inside the chunk's vertex buffer. Slots past count
+        // hold degenerate quads so a section can grow without moving the others.
+        struct MeshSection {
+            unsigned int firstQuad = 0;
+            unsigned int capacity = 0;
+            unsigned int count = 0;
+        };
+
+        void rebuildMesh(const ChunkMeshOutput& output);
+
+        RowMask getFullRow() const;
+        // Switches between uniform and row storage
+        void materialize();
+        void collapseIfUniform();
+        void releaseRows();
+        void releaseMesh();
+
+        // Finishes a row write after the materials of the changed bits were written
+        void updateRowOccupancy(int y, int z, RowMask changed, bool solid);
+
+        int getVoxelIndex(VoxelLayout layout, int x, int y, int z) const;
+
+        // Local coordinates of the voxel at (u, v) on the given face's boundary plane
+        void getBoundaryVoxel(int face, int u, int v, int& x, int& y, int& z) const;
+
+        void addToDirtyList();
 
         int m_chunkX;
         int m_chunkY;
         int m_chunkZ;
-        int m_size;
+        VoxelLayout m_layout;
+        VoxelChunk* m_neighbors[6];
+        ChunkPools* m_pools;
 
-        // Voxel data
-        std::vector<bool> m_voxels;
+        // Voxel data, Shape::ROW_COUNT rows or nullptr while uniform
+        RowMask* m_rows;
+        bool m_uniformSolid;
+        int m_solidCount;
+        // Solid voxels in each x, y and z plane of the chunk
+        std::array<uint16_t, SIZE_X> m_countX;
+        std::array<uint16_t, SIZE_Y> m_countY;
+        std::array<uint16_t, SIZE_Z> m_countZ;
+        PaletteStorage m_materials;
 
-        // Mesh data
-        renderer::Mesh* m_mesh;
-        bool m_dirty;
+        // Mesh data, quads of m_sections laid out back to back in the world's geometry arena
+        renderer::GeometryRange m_geometry;
+        std::vector<MeshSection> m_sections;
+        unsigned int m_dirtySections;
+        bool m_immediate;
+        DirtyChunkList* m_dirtyList;
+        bool m_inDirtyList;
+        bool m_meshInFlight;
+        unsigned int m_inFlightRevision;
+        unsigned int m_inFlightSections;
+        MeshingMode m_meshingMode;
+        unsigned int m_meshRevision;
+        unsigned int m_appliedRevision;
+        // Local bounds of the voxels behind the current mesh, min > max when none
+        VoxelPos m_meshMin;
+        VoxelPos m_meshMax;
+        int m_cullSlot;
     };
 
+    template <typename Function>
+    void VoxelChunk::forEachSolidVoxel(Function&& function) const {
+        if (isEmpty()) return;
+
+        for (int index = 0; index < Shape::VOLUME; index++) {
+            int x, y, z;
+            getVoxelPosition(index, x, y, z);
+            if (!hasVoxel(x, y, z)) continue;
+
+            function(x, y, z, m_materials.get(index));
+        }
+    }
+
 } // namespace voxel
 
@@ -64,23 +64,23 @@ namespace voxel {
         }
     }
 
-    bool VoxelSystem::addVoxel(int x, int y, int z) {
+    bool VoxelSystem::addVoxel(int x, int y, int z, bool immediate) {
         if (m_world) {
-            return m_world->addVoxel(x, y, z);
+            return m_world->addVoxel(x, y, z, immediate);
         }
         return false;
     }
 
-    bool VoxelSystem::removeVoxel(int x, int y, int z) {
+    bool VoxelSystem::removeVoxel(int x, int y, int z, bool immediate) {
         if (m_world) {
-            return m_world->removeVoxel(x, y, z);
+            return m_world->removeVoxel(x, y, z, immediate);
         }
         return false;
     }
 
-    bool VoxelSystem::toggleVoxel(int x, int y, int z) {
+    bool VoxelSystem::toggleVoxel(int x, int y, int z, bool immediate) {
         if (m_world) {
-            return m_world->toggleVoxel(x, y, z);
+            return m_world->toggleVoxel(x, y, z, immediate);
         }
         return false;
     }
@@ -92,6 +92,80 @@ namespace voxel {
         return false;
     }
 
+    int VoxelSystem::applyEdits(const std::vector<VoxelEdit>& edits, bool immediate) {
+        if (m_world) {
+            return m_world->applyEdits(edits, immediate);
+        }
+        return 0;
+    }
+
+    bool VoxelSystem::setVoxelMaterial(int x, int y, int z, MaterialId material, bool immediate) {
+        if (m_world) {
+            return m_world->setVoxelMaterial(x, y, z, material, immediate);
+        }
+        return false;
+    }
+
+    MaterialId VoxelSystem::getVoxelMaterial(int x, int y, int z) const {
+        if (m_world) {
+            return m_world->getVoxelMaterial(x, y, z);
+        }
+        return AIR_MATERIAL;
+    }
+
+    void VoxelSystem::setMaterialTransparent(MaterialId material, bool transparent) {
+        if (m_world) {
+            m_world->setMaterialTransparent(material, transparent);
+        }
+    }
+
+    int VoxelSystem::fillBox(const VoxelPos& min, const VoxelPos& max, bool value, bool immediate,
+        MaterialId material) {
+        if (m_world) {
+            return m_world->fillBox(min, max, value, immediate, material);
+        }
+        return 0;
+    }
+
+    int VoxelSystem::fillSphere(const glm::vec3& center, float radius, bool value, bool immediate,
+        MaterialId material) {
+        if (m_world) {
+            return m_world->fillSphere(center, radius, value, immediate, material);
+        }
+        return 0;
+    }
+
+    int VoxelSystem::carveSphere(const glm::vec3& center, float radius, bool immediate) {
+        if (m_world) {
+            return m_world->carveSphere(center, radius, immediate);
+        }
+        return 0;
+    }
+
+    int VoxelSystem::fillCylinder(const glm::vec3& base, float radius, int height, bool value, bool immediate,
+        MaterialId material) {
+        if (m_world) {
+            return m_world->fillCylinder(base, radius, height, value, immediate, material);
+        }
+        return 0;
+    }
+
+    int VoxelSystem::drawLine(const VoxelPos& from, const VoxelPos& to, bool value, bool immediate,
+        MaterialId material) {
+        if (m_world) {
+            return m_world->drawLine(from, to, value, immediate, material);
+        }
+        return 0;
+    }
+
+    int VoxelSystem::replace(const VoxelPos& min, const VoxelPos& max, MaterialId from, MaterialId to,
+        bool immediate) {
+        if (m_world) {
+            return m_world->replace(min, max, from, to, immediate);
+        }
+        return 0;
+    }
+
     bool VoxelSystem::raycast(const glm::vec3& origin, const glm::vec3& direction,
         VoxelPos& hitPos, FaceDirection& hitFace, float maxDistance) {
         if (m_world) {
@@ -100,6 +174,72 @@ namespace voxel {
         return false;
     }
 
+    void VoxelSystem::setMeshingMode(MeshingMode mode) {
+        if (m_world) {
+            m_world->setMeshingMode(mode);
+        }
+    }
+
+    MeshingMode VoxelSystem::getMeshingMode() const {
+        if (m_world) {
+            return m_world->getMeshingMode();
+        }
+        return MeshingMode::GREEDY;
+    }
+
+    void VoxelSystem::setVoxelLayout(VoxelLayout layout) {
+        if (m_world) {
+            m_world->setVoxelLayout(layout);
+        }
+    }
+
+    VoxelLayout VoxelSystem::getVoxelLayout() const {
+        if (m_world) {
+            return m_world->getVoxelLayout();
+        }
+        return VoxelLayout::LINEAR;
+    }
+
+    void VoxelSystem::setRemeshBudget(float milliseconds) {
+        if (m_world) {
+            m_world->setRemeshBudget(milliseconds);
+        }
+    }
+
+    RemeshStats VoxelSystem::getRemeshStats() const {
+        if (m_world) {
+            return m_world->getRemeshStats();
+        }
+        return RemeshStats();
+    }
+
+    CullStats VoxelSystem::getCullStats() const {
+        if (m_world) {
+            return m_world->getCullStats();
+        }
+        return CullStats();
+    }
+
+    int64_t VoxelSystem::getVoxelCount() const {
+        if (m_world) {
+            return m_world->getVoxelCount();
+        }
+        return 0;
+    }
+
+    bool VoxelSystem::getBounds(VoxelPos& min, VoxelPos& max) const {
+        if (m_world) {
+            return m_world->getBounds(min, max);
+        }
+        return false;
+    }
+
+    void VoxelSystem::setCamera(renderer::Camera* camera) {
+        if (m_world) {
+            m_world->setCamera(camera);
+        }
+    }
+
     VoxelWorld* VoxelSystem::getWorld() const {
         return m_world;
     }
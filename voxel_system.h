@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <unordered_map>
 #include <vector>
 #include <glm/glm.hpp>
@@ -21,6 +22,34 @@ namespace voxel {
         }
     };
 
+    // Voxel material, stored per voxel. Air is empty space, every other material is solid.
+    typedef uint16_t MaterialId;
+    const MaterialId AIR_MATERIAL = 0;
+    const MaterialId DEFAULT_MATERIAL = 1;
+
+    // Per-material properties used by meshing. Materials are opaque unless marked
+    // transparent; faces are hidden behind opaque voxels and between two voxels of
+    // the same transparent material.
+    struct MaterialTable {
+        std::vector<uint64_t> transparent = std::vector<uint64_t>(65536 / 64, 0);
+
+        bool isTransparent(MaterialId material) const {
+            return (transparent[material >> 6] >> (material & 63)) & 1;
+        }
+
+        void setTransparent(MaterialId material, bool value) {
+            uint64_t bit = uint64_t(1) << (material & 63);
+            transparent[material >> 6] = value ? (transparent[material >> 6] | bit) : (transparent[material >> 6] & ~bit);
+        }
+    };
+
+    // One entry of a batched edit, value true adds the voxel and false removes it
+    struct VoxelEdit {
+        VoxelPos pos;
+        bool value;
+        MaterialId material = DEFAULT_MATERIAL;
+    };
+
     // Face direction enum
     enum class FaceDirection {
         FRONT,  // -Z
@@ -31,6 +60,88 @@ namespace voxel {
         TOP     // +Y
     };
 
+    // One row of voxel occupancy along X, bit x set when the voxel is solid
+    typedef uint64_t RowMask;
+
+    // Power-of-two chunk extents fixed at compile time, so voxel indices, bounds checks
+    // and world to chunk conversion reduce to shifts and masks. X and Z must fit a
+    // RowMask; Y can be taller for column chunks.
+    template <int ShiftX, int ShiftY, int ShiftZ>
+    struct ChunkShape {
+        static_assert(ShiftX >= 2 && ShiftX <= 6 && ShiftZ >= 2 && ShiftZ <= 6, "X and Z must be 4 to 64 voxels");
+        static_assert(ShiftY >= 2 && ShiftY <= 8, "Y must be 4 to 256 voxels");
+
+        static constexpr int SHIFT_X = ShiftX;
+        static constexpr int SHIFT_Y = ShiftY;
+        static constexpr int SHIFT_Z = ShiftZ;
+        static constexpr int SIZE_X = 1 << ShiftX;
+        static constexpr int SIZE_Y = 1 << ShiftY;
+        static constexpr int SIZE_Z = 1 << ShiftZ;
+        static constexpr int MASK_X = SIZE_X - 1;
+        static constexpr int MASK_Y = SIZE_Y - 1;
+        static constexpr int MASK_Z = SIZE_Z - 1;
+        static constexpr int VOLUME = SIZE_X * SIZE_Y * SIZE_Z;
+        // Occupancy rows, one per (y, z)
+        static constexpr int ROW_COUNT = SIZE_Y * SIZE_Z;
+
+        static constexpr bool contains(int x, int y, int z) {
+            return static_cast<unsigned int>(x) < SIZE_X &&
+                static_cast<unsigned int>(y) < SIZE_Y &&
+                static_cast<unsigned int>(z) < SIZE_Z;
+        }
+
+        static constexpr int getRowIndex(int y, int z) {
+            return (z << ShiftY) | y;
+        }
+
+        static constexpr int getVoxelIndex(int x, int y, int z) {
+            return (getRowIndex(y, z) << ShiftX) | x;
+        }
+
+        static constexpr int getSize(int axis) {
+            return axis == 0 ? SIZE_X : axis == 1 ? SIZE_Y : SIZE_Z;
+        }
+    };
+
+    typedef ChunkShape<4, 4, 4> ChunkShape16;
+    typedef ChunkShape<5, 5, 5> ChunkShape32;
+    typedef ChunkShape<5, 8, 5> ColumnChunkShape;
+
+    // The chunk shape the engine is built with, pick one of the above
+    typedef ChunkShape16 WorldChunkShape;
+
+    // Chunk meshing strategy
+    enum class MeshingMode {
+        NAIVE,  // One quad per exposed voxel face
+        GREEDY  // Coplanar exposed faces merged into maximal rectangles
+    };
+
+    // Order in which a chunk stores its per-voxel materials. Occupancy rows are
+    // always kept in (y, z) row order for the mesher.
+    enum class VoxelLayout {
+        LINEAR, // (z * size + y) * size + x
+        MORTON, // Z-order curve, bits of x, y and z interleaved
+        BRICK   // 4x4x4 bricks in linear order, linear within each brick
+    };
+
+    // Per-frame chunk remeshing statistics
+    struct RemeshStats {
+        float budgetMs = 0.0f;     // Main thread time allowed for remeshing per frame
+        float usedMs = 0.0f;       // Time actually spent last frame
+        int backlog = 0;           // Dirty chunks left waiting for a later frame
+        int pendingJobs = 0;       // Snapshots being meshed on worker threads
+        int immediateChunks = 0;   // Chunks meshed synchronously for player edits last frame
+        int submittedChunks = 0;   // Chunks handed to the workers last frame
+        int skippedChunks = 0;     // Of those, empty or enclosed chunks cleared without meshing
+        int uploadedChunks = 0;    // Finished meshes uploaded last frame
+    };
+
+    // Chunk frustum culling of the last rendered frame
+    struct CullStats {
+        int drawnChunks = 0;       // Chunks whose bounds intersect the view frustum
+        int culledChunks = 0;      // Chunks with a mesh skipped as off screen
+    };
+
     // Hash function for VoxelPos
     struct VoxelPosHash {
         size_t operator()(const VoxelPos& pos) const {
@@ -52,16 +163,54 @@ namespace voxel {
         void update(float deltaTime);
         void render(renderer::Renderer* renderer, renderer::Camera* camera);
 
-        // Voxel manipulation
-        bool addVoxel(int x, int y, int z);
-        bool removeVoxel(int x, int y, int z);
-        bool toggleVoxel(int x, int y, int z);
+        // Voxel manipulation. Immediate edits (e.g. from the player) are remeshed
+        // in the same frame instead of waiting in the budgeted remesh queue.
+        bool addVoxel(int x, int y, int z, bool immediate = false);
+        bool removeVoxel(int x, int y, int z, bool immediate = false);
+        bool toggleVoxel(int x, int y, int z, bool immediate = false);
         bool hasVoxel(int x, int y, int z) const;
 
+        // Applies many edits at once, grouped by chunk. Later edits to the same voxel win.
+        // Returns the number of voxels that changed.
+        int applyEdits(const std::vector<VoxelEdit>& edits, bool immediate = false);
+
+        // Materials, see VoxelWorld
+        bool setVoxelMaterial(int x, int y, int z, MaterialId material, bool immediate = false);
+        MaterialId getVoxelMaterial(int x, int y, int z) const;
+        void setMaterialTransparent(MaterialId material, bool transparent);
+
+        // Shape brushes, see VoxelWorld. Each returns the number of voxels that changed.
+        int fillBox(const VoxelPos& min, const VoxelPos& max, bool value = true, bool immediate = false,
+            MaterialId material = DEFAULT_MATERIAL);
+        int fillSphere(const glm::vec3& center, float radius, bool value = true, bool immediate = false,
+            MaterialId material = DEFAULT_MATERIAL);
+        int carveSphere(const glm::vec3& center, float radius, bool immediate = false);
+        int fillCylinder(const glm::vec3& base, float radius, int height, bool value = true, bool immediate = false,
+            MaterialId material = DEFAULT_MATERIAL);
+        int drawLine(const VoxelPos& from, const VoxelPos& to, bool value = true, bool immediate = false,
+            MaterialId material = DEFAULT_MATERIAL);
+        int replace(const VoxelPos& min, const VoxelPos& max, MaterialId from, MaterialId to, bool immediate = false);
+
         // Raycast
         bool raycast(const glm::vec3& origin, const glm::vec3& direction,
             VoxelPos& hitPos, FaceDirection& hitFace, float maxDistance = 10.0f);
 
+        // Meshing
+        void setMeshingMode(MeshingMode mode);
+        MeshingMode getMeshingMode() const;
+        void setVoxelLayout(VoxelLayout layout);
+        VoxelLayout getVoxelLayout() const;
+        void setRemeshBudget(float milliseconds);
+        RemeshStats getRemeshStats() const;
+        CullStats getCullStats() const;
+
+        // World occupancy, see VoxelWorld
+        int64_t getVoxelCount() const;
+        bool getBounds(VoxelPos& min, VoxelPos& max) const;
+
+        // Camera used to prioritize chunk remeshing
+        void setCamera(renderer::Camera* camera);
+
         // World access
         VoxelWorld* getWorld() const;
 
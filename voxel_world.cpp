@@ -1,14 +1,104 @@
 #include "voxel_world.h"
 #include "voxel_chunk.h"
+#include "chunk_mesher.h"
 #include "renderer.h"
 #include "camera.h"
 #include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <bit>
+#include <chrono>
 #include <iostream>
 #include <cmath>
+#include <cstdlib>
 
 namespace voxel {
 
-    VoxelWorld::VoxelWorld() {
+    namespace {
+
+        // Monotonic time in milliseconds for the remesh budget
+        double getTimeMs() {
+            using namespace std::chrono;
+            return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+        }
+
+    } // namespace
+
+    VoxelWorld::Accessor::Accessor(VoxelWorld& world)
+        : m_world(world)
+        , m_chunk(nullptr)
+        , m_chunkX(0)
+        , m_chunkY(0)
+        , m_chunkZ(0)
+    {
+    }
+
+    bool VoxelWorld::Accessor::hasVoxel(int x, int y, int z) {
+        int chunkX, chunkY, chunkZ, localX, localY, localZ;
+        m_world.worldToChunkCoords(x, y, z, chunkX, chunkY, chunkZ, localX, localY, localZ);
+
+        VoxelChunk* chunk = getChunk(chunkX, chunkY, chunkZ);
+        return chunk && chunk->hasVoxel(localX, localY, localZ);
+    }
+
+    bool VoxelWorld::Accessor::setVoxel(int x, int y, int z, bool value, bool immediate) {
+        int chunkX, chunkY, chunkZ, localX, localY, localZ;
+        m_world.worldToChunkCoords(x, y, z, chunkX, chunkY, chunkZ, localX, localY, localZ);
+
+        VoxelChunk* chunk = getChunk(chunkX, chunkY, chunkZ);
+        if (!chunk && value) {
+            chunk = m_world.getOrCreateChunk(chunkX, chunkY, chunkZ);
+            m_chunk = chunk;
+            m_chunkX = chunkX;
+            m_chunkY = chunkY;
+            m_chunkZ = chunkZ;
+        }
+
+        return chunk && m_world.setChunkVoxel(chunk, localX, localY, localZ, value, immediate);
+    }
+
+    VoxelChunk* VoxelWorld::Accessor::getChunk(int chunkX, int chunkY, int chunkZ) {
+        if (m_chunk) {
+            int dx = chunkX - m_chunkX;
+            int dy = chunkY - m_chunkY;
+            int dz = chunkZ - m_chunkZ;
+
+            if (dx == 0 && dy == 0 && dz == 0) {
+                return m_chunk;
+            }
+
+            // One step across a face: follow the neighbour pointer. A missing
+            // neighbour is not loaded, so no map lookup is needed either way.
+            if (std::abs(dx) + std::abs(dy) + std::abs(dz) == 1) {
+                int face = dz != 0 ? (dz > 0 ? 1 : 0) : dx != 0 ? (dx > 0 ? 3 : 2) : (dy > 0 ? 5 : 4);
+                VoxelChunk* neighbor = m_chunk->getNeighbor(face);
+                if (!neighbor) return nullptr;
+
+                m_chunk = neighbor;
+                m_chunkX = chunkX;
+                m_chunkY = chunkY;
+                m_chunkZ = chunkZ;
+                return m_chunk;
+            }
+        }
+
+        // Only loaded chunks are cached, they cannot appear behind the accessor's back
+        VoxelChunk* chunk = m_world.getChunk(chunkX, chunkY, chunkZ);
+        if (chunk) {
+            m_chunk = chunk;
+            m_chunkX = chunkX;
+            m_chunkY = chunkY;
+            m_chunkZ = chunkZ;
+        }
+        return chunk;
+    }
+
+    VoxelWorld::VoxelWorld()
+        : m_meshingMode(MeshingMode::GREEDY)
+        , m_voxelLayout(VoxelLayout::LINEAR)
+        , m_camera(nullptr)
+        , m_remeshBudgetMs(2.0f)
+    {
+        m_remeshStats.budgetMs = m_remeshBudgetMs;
     }
 
     VoxelWorld::~VoxelWorld() {
@@ -16,6 +106,11 @@ namespace voxel {
     }
 
     bool VoxelWorld::initialize() {
+        // Start the mesh workers
+        if (!m_meshThreadPool.initialize()) {
+            return false;
+        }
+
         // Create a few initial chunks
         getOrCreateChunk(0, 0, 0);
 
@@ -29,73 +124,463 @@ namespace voxel {
     }
 
     void VoxelWorld::shutdown() {
-        // Delete all chunks
-        for (auto& xMap : m_chunks) {
-            for (auto& yMap : xMap.second) {
-                for (auto& chunk : yMap.second) {
-                    delete chunk.second;
-                }
-            }
+        // Stop meshing before the chunks go away
+        m_meshThreadPool.shutdown();
+
+        // Destroy all chunks, then hand the pooled memory and meshes back in one go
+        m_culler.clear();
+        for (VoxelChunk* chunk : m_chunks) {
+            m_chunkPool.destroy(chunk);
         }
 
         m_chunks.clear();
+        m_dirtyChunks.clear();
+        m_chunkPool.releaseAll();
+        m_chunkPools.rows.releaseAll();
+        m_chunkPools.geometry.clear();
     }
 
     void VoxelWorld::update(float deltaTime) {
-        // Update all chunks
-        for (auto& xMap : m_chunks) {
-            for (auto& yMap : xMap.second) {
-                for (auto& chunk : yMap.second) {
-                    chunk.second->update(deltaTime);
-                }
+        double frameStart = getTimeMs();
+        RemeshStats stats;
+        stats.budgetMs = m_remeshBudgetMs;
+
+        // Upload whatever the workers finished, within the budget
+        stats.uploadedChunks = applyFinishedMeshes(frameStart, m_remeshBudgetMs);
+
+        // Player edits are remeshed right away, the rest is queued by priority. Only chunks
+        // on the dirty list are visited, so an idle world costs nothing here.
+        m_remeshQueue.clear();
+        for (size_t i = 0; i < m_dirtyChunks.size(); i++) {
+            VoxelChunk* dirtyChunk = m_dirtyChunks[i];
+            if (!dirtyChunk->isDirty()) continue;
+
+            if (dirtyChunk->needsImmediateRemesh()) {
+                rebuildChunkMeshNow(dirtyChunk);
+                stats.immediateChunks++;
+            }
+            else if (!dirtyChunk->isMeshInFlight()) {
+                m_remeshQueue.emplace_back(getRemeshPriority(dirtyChunk), dirtyChunk);
             }
         }
+
+        std::sort(m_remeshQueue.begin(), m_remeshQueue.end(),
+            [](const std::pair<float, VoxelChunk*>& a, const std::pair<float, VoxelChunk*>& b) {
+                return a.first < b.first;
+            });
+
+        // Hand chunks to the workers until the budget runs out, their current meshes keep
+        // rendering meanwhile. At least one chunk is submitted so the backlog always drains.
+        for (auto& entry : m_remeshQueue) {
+            if (stats.submittedChunks > 0 && getTimeMs() - frameStart >= m_remeshBudgetMs) break;
+
+            ChunkMeshJob job;
+            m_meshThreadPool.acquireJob(job);
+            if (createMeshJob(entry.second, job, true)) {
+                m_meshThreadPool.submit(std::move(job));
+            }
+            else {
+                applyEmptyMesh(entry.second, job);
+                // Nothing to mesh, the snapshot buffers go back for the next job
+                m_meshThreadPool.recycleInput(std::move(job.input));
+                stats.skippedChunks++;
+            }
+            stats.submittedChunks++;
+        }
+
+        // Chunks left dirty (over budget or waiting on a worker) stay listed
+        m_dirtyChunks.erase(std::remove_if(m_dirtyChunks.begin(), m_dirtyChunks.end(),
+            [](VoxelChunk* chunk) {
+                if (chunk->isDirty()) return false;
+                chunk->setInDirtyList(false);
+                return true;
+            }), m_dirtyChunks.end());
+
+        stats.backlog = static_cast<int>(m_remeshQueue.size()) - stats.submittedChunks;
+        stats.pendingJobs = m_meshThreadPool.getPendingCount();
+        stats.usedMs = static_cast<float>(getTimeMs() - frameStart);
+        m_remeshStats = stats;
     }
 
     void VoxelWorld::render(renderer::Renderer* renderer, renderer::Camera* camera) {
         if (!renderer || !camera) return;
 
-        // Render all chunks
-        for (auto& xMap : m_chunks) {
-            for (auto& yMap : xMap.second) {
-                for (auto& chunk : yMap.second) {
-                    chunk.second->render(renderer, camera);
-                }
+        // Only chunks whose boxes touch the view frustum are drawn
+        m_visibleChunks.clear();
+        m_culler.cull(camera->getFrustum(), m_visibleChunks);
+
+        // All visible chunks go to the renderer in one batch
+        m_chunkDraws.clear();
+        for (VoxelChunk* chunk : m_visibleChunks) {
+            renderer::ChunkDraw draw;
+            if (chunk->getDraw(draw)) {
+                m_chunkDraws.push_back(draw);
             }
         }
+
+        renderer->drawChunks(m_chunkPools.geometry, m_chunkDraws.data(), m_chunkDraws.size(),
+            glm::vec3(0.9f, 0.5f, 0.2f));
+        m_cullStats.drawnChunks = static_cast<int>(m_visibleChunks.size());
+        m_cullStats.culledChunks = static_cast<int>(m_culler.getCount() - m_visibleChunks.size());
     }
 
-    bool VoxelWorld::addVoxel(int x, int y, int z) {
+    bool VoxelWorld::addVoxel(int x, int y, int z, bool immediate) {
         int chunkX, chunkY, chunkZ, localX, localY, localZ;
         worldToChunkCoords(x, y, z, chunkX, chunkY, chunkZ, localX, localY, localZ);
 
         VoxelChunk* chunk = getOrCreateChunk(chunkX, chunkY, chunkZ);
-        if (chunk) {
-            return chunk->setVoxel(localX, localY, localZ, true);
-        }
-
-        return false;
+        return chunk && setChunkVoxel(chunk, localX, localY, localZ, true, immediate);
     }
 
-    bool VoxelWorld::removeVoxel(int x, int y, int z) {
+    bool VoxelWorld::removeVoxel(int x, int y, int z, bool immediate) {
         int chunkX, chunkY, chunkZ, localX, localY, localZ;
         worldToChunkCoords(x, y, z, chunkX, chunkY, chunkZ, localX, localY, localZ);
 
         VoxelChunk* chunk = getChunk(chunkX, chunkY, chunkZ);
-        if (chunk) {
-            return chunk->setVoxel(localX, localY, localZ, false);
+        return chunk && setChunkVoxel(chunk, localX, localY, localZ, false, immediate);
+    }
+
+    bool VoxelWorld::setVoxelMaterial(int x, int y, int z, MaterialId material, bool immediate) {
+        int chunkX, chunkY, chunkZ, localX, localY, localZ;
+        worldToChunkCoords(x, y, z, chunkX, chunkY, chunkZ, localX, localY, localZ);
+
+        VoxelChunk* chunk = material != AIR_MATERIAL ?
+            getOrCreateChunk(chunkX, chunkY, chunkZ) :
+            getChunk(chunkX, chunkY, chunkZ);
+        if (!chunk || !chunk->writeMaterial(localX, localY, localZ, material)) return false;
+
+        markVoxelChanged(chunk, localX, localY, localZ, immediate);
+        return true;
+    }
+
+    MaterialId VoxelWorld::getVoxelMaterial(int x, int y, int z) const {
+        int chunkX, chunkY, chunkZ, localX, localY, localZ;
+        worldToChunkCoords(x, y, z, chunkX, chunkY, chunkZ, localX, localY, localZ);
+
+        VoxelChunk* chunk = m_chunks.find(chunkX, chunkY, chunkZ);
+        return chunk ? chunk->getMaterial(localX, localY, localZ) : AIR_MATERIAL;
+    }
+
+    void VoxelWorld::setMaterialTransparent(MaterialId material, bool transparent) {
+        if (material == AIR_MATERIAL || m_materialTable.isTransparent(material) == transparent) return;
+
+        m_materialTable.setTransparent(material, transparent);
+
+        // Culling changes wherever the material is used
+        for (VoxelChunk* chunk : m_chunks) {
+            if (chunk->containsMaterial(material)) {
+                chunk->markDirty();
+                for (int face = 0; face < 6; face++) {
+                    if (chunk->getNeighbor(face)) chunk->getNeighbor(face)->markDirty();
+                }
+            }
         }
+    }
 
-        return false;
+    bool VoxelWorld::isMaterialTransparent(MaterialId material) const {
+        return m_materialTable.isTransparent(material);
     }
 
-    bool VoxelWorld::toggleVoxel(int x, int y, int z) {
+    bool VoxelWorld::toggleVoxel(int x, int y, int z, bool immediate) {
         if (hasVoxel(x, y, z)) {
-            return removeVoxel(x, y, z);
+            return removeVoxel(x, y, z, immediate);
         }
         else {
-            return addVoxel(x, y, z);
+            return addVoxel(x, y, z, immediate);
+        }
+    }
+
+    int VoxelWorld::applyEdits(const std::vector<VoxelEdit>& edits, bool immediate) {
+        // Split every position once and group the edits by chunk. Ties are broken by
+        // submission order, which keeps later edits to a voxel winning without the
+        // temporary buffer std::stable_sort allocates on every call.
+        m_editBuffer.clear();
+        m_editBuffer.reserve(edits.size());
+
+        for (const VoxelEdit& edit : edits) {
+            PendingEdit pending;
+            int localX, localY, localZ;
+            worldToChunkCoords(edit.pos.x, edit.pos.y, edit.pos.z,
+                pending.chunkX, pending.chunkY, pending.chunkZ, localX, localY, localZ);
+
+            pending.chunkKey = ChunkMap::packKey(pending.chunkX, pending.chunkY, pending.chunkZ);
+            pending.localX = static_cast<uint8_t>(localX);
+            pending.localY = static_cast<uint8_t>(localY);
+            pending.localZ = static_cast<uint8_t>(localZ);
+            pending.material = edit.value ? edit.material : AIR_MATERIAL;
+            pending.order = static_cast<uint32_t>(m_editBuffer.size());
+            m_editBuffer.push_back(pending);
+        }
+
+        std::sort(m_editBuffer.begin(), m_editBuffer.end(),
+            [](const PendingEdit& a, const PendingEdit& b) {
+                if (a.chunkKey != b.chunkKey) return a.chunkKey < b.chunkKey;
+                return a.order < b.order;
+            });
+
+        int changed = 0;
+        size_t begin = 0;
+
+        while (begin < m_editBuffer.size()) {
+            const PendingEdit& first = m_editBuffer[begin];
+
+            size_t end = begin + 1;
+            bool addsVoxels = first.material != AIR_MATERIAL;
+            while (end < m_editBuffer.size() && m_editBuffer[end].chunkKey == first.chunkKey) {
+                addsVoxels = addsVoxels || m_editBuffer[end].material != AIR_MATERIAL;
+                end++;
+            }
+
+            // Chunks are only created for runs that add voxels
+            VoxelChunk* chunk = addsVoxels ?
+                getOrCreateChunk(first.chunkX, first.chunkY, first.chunkZ) :
+                getChunk(first.chunkX, first.chunkY, first.chunkZ);
+
+            if (chunk) {
+                unsigned int sections = 0;
+                unsigned int neighborSections[6] = { 0, 0, 0, 0, 0, 0 };
+
+                for (size_t i = begin; i < end; i++) {
+                    const PendingEdit& edit = m_editBuffer[i];
+                    // Sections are marked once for the whole run below
+                    if (!chunk->writeMaterial(edit.localX, edit.localY, edit.localZ, edit.material)) continue;
+
+                    changed++;
+                    sections |= chunk->getAffectedSections(edit.localY);
+                    collectNeighborSections(edit.localY, edit.localZ, RowMask(1) << edit.localX, neighborSections);
+                }
+
+                if (sections) {
+                    chunk->markSectionsDirty(sections, immediate);
+                    markNeighborSectionsDirty(chunk, neighborSections, immediate);
+                }
+            }
+
+            begin = end;
+        }
+
+        return changed;
+    }
+
+    namespace {
+
+        // Row spans of an axis-aligned box, already clipped by fillShape
+        bool boxRowSpan(const VoxelPos& min, const VoxelPos& max, int& minX, int& maxX) {
+            minX = min.x;
+            maxX = max.x;
+            return true;
+        }
+
+    } // namespace
+
+    int VoxelWorld::fillBox(const VoxelPos& min, const VoxelPos& max, bool value, bool immediate,
+        MaterialId material) {
+        return fillShape(min, max,
+            [&](int, int, int& minX, int& maxX) { return boxRowSpan(min, max, minX, maxX); },
+            value ? material : AIR_MATERIAL, immediate);
+    }
+
+    int VoxelWorld::replace(const VoxelPos& min, const VoxelPos& max, MaterialId from, MaterialId to,
+        bool immediate) {
+        if (from == to) return 0;
+
+        return fillShape(min, max,
+            [&](int, int, int& minX, int& maxX) { return boxRowSpan(min, max, minX, maxX); },
+            to, immediate, true, from);
+    }
+
+    int VoxelWorld::fillSphere(const glm::vec3& center, float radius, bool value, bool immediate,
+        MaterialId material) {
+        if (radius <= 0.0f) return 0;
+
+        VoxelPos min = { static_cast<int>(std::floor(center.x - radius)),
+            static_cast<int>(std::floor(center.y - radius)), static_cast<int>(std::floor(center.z - radius)) };
+        VoxelPos max = { static_cast<int>(std::ceil(center.x + radius)),
+            static_cast<int>(std::ceil(center.y + radius)), static_cast<int>(std::ceil(center.z + radius)) };
+
+        return fillShape(min, max,
+            [&](int y, int z, int& minX, int& maxX) {
+                float dy = y + 0.5f - center.y;
+                float dz = z + 0.5f - center.z;
+                float remaining = radius * radius - dy * dy - dz * dz;
+                if (remaining < 0.0f) return false;
+
+                float halfWidth = std::sqrt(remaining);
+                minX = static_cast<int>(std::ceil(center.x - halfWidth - 0.5f));
+                maxX = static_cast<int>(std::floor(center.x + halfWidth - 0.5f));
+                return minX <= maxX;
+            },
+            value ? material : AIR_MATERIAL, immediate);
+    }
+
+    int VoxelWorld::carveSphere(const glm::vec3& center, float radius, bool immediate) {
+        return fillSphere(center, radius, false, immediate, AIR_MATERIAL);
+    }
+
+    int VoxelWorld::fillCylinder(const glm::vec3& base, float radius, int height, bool value, bool immediate,
+        MaterialId material) {
+        if (radius <= 0.0f || height <= 0) return 0;
+
+        int bottom = static_cast<int>(std::floor(base.y));
+        VoxelPos min = { static_cast<int>(std::floor(base.x - radius)), bottom,
+            static_cast<int>(std::floor(base.z - radius)) };
+        VoxelPos max = { static_cast<int>(std::ceil(base.x + radius)), bottom + height - 1,
+            static_cast<int>(std::ceil(base.z + radius)) };
+
+        return fillShape(min, max,
+            [&](int, int z, int& minX, int& maxX) {
+                float dz = z + 0.5f - base.z;
+                float remaining = radius * radius - dz * dz;
+                if (remaining < 0.0f) return false;
+
+                float halfWidth = std::sqrt(remaining);
+                minX = static_cast<int>(std::ceil(base.x - halfWidth - 0.5f));
+                maxX = static_cast<int>(std::floor(base.x + halfWidth - 0.5f));
+                return minX <= maxX;
+            },
+            value ? material : AIR_MATERIAL, immediate);
+    }
+
+    int VoxelWorld::drawLine(const VoxelPos& from, const VoxelPos& to, bool value, bool immediate,
+        MaterialId material) {
+        // 3D Bresenham, stepping along the dominant axis
+        int dx = std::abs(to.x - from.x);
+        int dy = std::abs(to.y - from.y);
+        int dz = std::abs(to.z - from.z);
+        int stepX = to.x > from.x ? 1 : -1;
+        int stepY = to.y > from.y ? 1 : -1;
+        int stepZ = to.z > from.z ? 1 : -1;
+        int steps = std::max(dx, std::max(dy, dz));
+
+        // The member buffer keeps its capacity, so redrawing lines every frame does not allocate
+        m_lineEdits.clear();
+        m_lineEdits.reserve(steps + 1);
+
+        VoxelPos pos = from;
+        int errorX = steps / 2;
+        int errorY = steps / 2;
+        int errorZ = steps / 2;
+
+        for (int i = 0; i <= steps; i++) {
+            m_lineEdits.push_back({ pos, value, material });
+
+            errorX -= dx;
+            errorY -= dy;
+            errorZ -= dz;
+            if (errorX < 0) { pos.x += stepX; errorX += steps; }
+            if (errorY < 0) { pos.y += stepY; errorY += steps; }
+            if (errorZ < 0) { pos.z += stepZ; errorZ += steps; }
+        }
+
+        return applyEdits(m_lineEdits, immediate);
+    }
+
+    int VoxelWorld::fillShape(const VoxelPos& min, const VoxelPos& max, const RowSpanFunction& rowSpan,
+        MaterialId material, bool immediate, bool replacing, MaterialId from) {
+        if (min.x > max.x || min.y > max.y || min.z > max.z) return 0;
+
+        int minChunkX, minChunkY, minChunkZ, maxChunkX, maxChunkY, maxChunkZ, localX, localY, localZ;
+        worldToChunkCoords(min.x, min.y, min.z, minChunkX, minChunkY, minChunkZ, localX, localY, localZ);
+        worldToChunkCoords(max.x, max.y, max.z, maxChunkX, maxChunkY, maxChunkZ, localX, localY, localZ);
+
+        RowMask fullRow = (CHUNK_SIZE_X == 64) ? ~RowMask(0) : (RowMask(1) << CHUNK_SIZE_X) - 1;
+        m_shapeRows.resize(WorldChunkShape::ROW_COUNT);
+
+        int changed = 0;
+        for (int chunkZ = minChunkZ; chunkZ <= maxChunkZ; chunkZ++) {
+            for (int chunkY = minChunkY; chunkY <= maxChunkY; chunkY++) {
+                for (int chunkX = minChunkX; chunkX <= maxChunkX; chunkX++) {
+                    int originX = chunkX << WorldChunkShape::SHIFT_X;
+                    int originY = chunkY << WorldChunkShape::SHIFT_Y;
+                    int originZ = chunkZ << WorldChunkShape::SHIFT_Z;
+
+                    // Rasterize the shape into this chunk's rows
+                    bool anyRow = false;
+                    bool fullChunk = true;
+                    for (int z = 0; z < CHUNK_SIZE_Z; z++) {
+                        for (int y = 0; y < CHUNK_SIZE_Y; y++) {
+                            int worldY = originY + y;
+                            int worldZ = originZ + z;
+                            int minX, maxX;
+                            RowMask mask = 0;
+
+                            if (worldY >= min.y && worldY <= max.y && worldZ >= min.z && worldZ <= max.z &&
+                                rowSpan(worldY, worldZ, minX, maxX)) {
+                                minX = std::max(std::max(minX, min.x), originX) - originX;
+                                maxX = std::min(std::min(maxX, max.x), originX + CHUNK_SIZE_X - 1) - originX;
+                                if (minX <= maxX) {
+                                    mask = (~RowMask(0) >> (63 - (maxX - minX))) << minX;
+                                }
+                            }
+
+                            m_shapeRows[WorldChunkShape::getRowIndex(y, z)] = mask;
+                            anyRow = anyRow || mask != 0;
+                            fullChunk = fullChunk && mask == fullRow;
+                        }
+                    }
+
+                    if (!anyRow) continue;
+
+                    // Only writes that produce solid voxels create chunks
+                    bool createsVoxels = replacing ? from == AIR_MATERIAL : material != AIR_MATERIAL;
+                    VoxelChunk* chunk = createsVoxels ?
+                        getOrCreateChunk(chunkX, chunkY, chunkZ) :
+                        getChunk(chunkX, chunkY, chunkZ);
+                    if (!chunk) continue;
+                    if (replacing && !chunk->containsMaterial(from)) continue;
+
+                    // Replacing covers the whole chunk only if every voxel has the old material
+                    if (replacing && fullChunk) {
+                        bool mixed;
+                        fullChunk = chunk->getMaterials().getUniformMaterial(mixed) == from && !mixed;
+                    }
+
+                    unsigned int neighborSections[6] = { 0, 0, 0, 0, 0, 0 };
+                    int chunkChanged = 0;
+
+                    if (fullChunk) {
+                        chunkChanged = chunk->fill(material);
+                        if (chunkChanged) {
+                            chunk->markDirty(immediate);
+
+                            neighborSections[0] = neighborSections[1] = ChunkMesher::ALL_SECTIONS;
+                            neighborSections[2] = neighborSections[3] = ChunkMesher::ALL_SECTIONS;
+                            neighborSections[4] = ChunkMesher::getSection(CHUNK_SIZE_Y - 1);
+                            neighborSections[5] = ChunkMesher::getSection(0);
+                        }
+                    }
+                    else {
+                        unsigned int sections = 0;
+                        for (int z = 0; z < CHUNK_SIZE_Z; z++) {
+                            for (int y = 0; y < CHUNK_SIZE_Y; y++) {
+                                RowMask mask = m_shapeRows[WorldChunkShape::getRowIndex(y, z)];
+                                if (!mask) continue;
+
+                                RowMask rowChanged = replacing ?
+                                    chunk->replaceRowMaterial(y, z, mask, from, material) :
+                                    chunk->setRowMaterial(y, z, mask, material);
+                                if (!rowChanged) continue;
+
+                                chunkChanged += std::popcount(rowChanged);
+                                sections |= chunk->getAffectedSections(y);
+                                collectNeighborSections(y, z, rowChanged, neighborSections);
+                            }
+                        }
+
+                        if (sections) {
+                            chunk->markSectionsDirty(sections, immediate);
+                        }
+                    }
+
+                    if (chunkChanged) {
+                        markNeighborSectionsDirty(chunk, neighborSections, immediate);
+                        changed += chunkChanged;
+                    }
+                }
+            }
         }
+
+        return changed;
     }
 
     bool VoxelWorld::hasVoxel(int x, int y, int z) const {
@@ -103,16 +588,10 @@ namespace voxel {
         worldToChunkCoords(x, y, z, chunkX, chunkY, chunkZ, localX, localY, localZ);
 
         // Find chunk
-        auto xIt = m_chunks.find(chunkX);
-        if (xIt == m_chunks.end()) return false;
+        VoxelChunk* chunk = m_chunks.find(chunkX, chunkY, chunkZ);
+        if (!chunk) return false;
 
-        auto yIt = xIt->second.find(chunkY);
-        if (yIt == xIt->second.end()) return false;
-
-        auto zIt = yIt->second.find(chunkZ);
-        if (zIt == yIt->second.end()) return false;
-
-        return zIt->second->hasVoxel(localX, localY, localZ);
+        return chunk->hasVoxel(localX, localY, localZ);
     }
 
     bool VoxelWorld::raycast(const glm::vec3& origin, const glm::vec3& direction,
@@ -120,6 +599,9 @@ namespace voxel {
         // Implementation of a fast voxel traversal algorithm
         // Based on "A Fast Voxel Traversal Algorithm for Ray Tracing"
 
+        // Consecutive steps stay in the same or an adjacent chunk
+        Accessor accessor(*this);
+
         // Normalize direction
         glm::vec3 dir = glm::normalize(direction);
 
@@ -150,7 +632,7 @@ namespace voxel {
         float t = 0.0f;
 
         // Avoid starting inside a voxel
-        if (hasVoxel(x, y, z)) {
+        if (accessor.hasVoxel(x, y, z)) {
             hitPos = { x, y, z };
 
             // Determine hit face based on ray direction
@@ -190,7 +672,7 @@ namespace voxel {
             }
 
             // Check if we hit a voxel
-            if (hasVoxel(x, y, z)) {
+            if (accessor.hasVoxel(x, y, z)) {
                 hitPos = { x, y, z };
                 return true;
             }
@@ -200,17 +682,109 @@ namespace voxel {
         return false;
     }
 
-    VoxelChunk* VoxelWorld::getChunk(int chunkX, int chunkY, int chunkZ) {
-        auto xIt = m_chunks.find(chunkX);
-        if (xIt == m_chunks.end()) return nullptr;
+    int64_t VoxelWorld::getVoxelCount() const {
+        int64_t count = 0;
+        for (VoxelChunk* chunk : m_chunks) {
+            count += chunk->getSolidCount();
+        }
+        return count;
+    }
+
+    bool VoxelWorld::getBounds(VoxelPos& min, VoxelPos& max) const {
+        bool found = false;
+
+        for (VoxelChunk* chunk : m_chunks) {
+            VoxelPos chunkMin, chunkMax;
+            if (!chunk->getBounds(chunkMin, chunkMax)) continue;
+
+            glm::ivec3 origin(chunk->getChunkX() * CHUNK_SIZE_X, chunk->getChunkY() * CHUNK_SIZE_Y,
+                chunk->getChunkZ() * CHUNK_SIZE_Z);
+            VoxelPos low = { origin.x + chunkMin.x, origin.y + chunkMin.y, origin.z + chunkMin.z };
+            VoxelPos high = { origin.x + chunkMax.x, origin.y + chunkMax.y, origin.z + chunkMax.z };
+
+            if (!found) {
+                min = low;
+                max = high;
+                found = true;
+                continue;
+            }
+
+            min = { std::min(min.x, low.x), std::min(min.y, low.y), std::min(min.z, low.z) };
+            max = { std::max(max.x, high.x), std::max(max.y, high.y), std::max(max.z, high.z) };
+        }
+
+        return found;
+    }
+
+    void VoxelWorld::getNonEmptyChunks(std::vector<VoxelChunk*>& chunks) const {
+        chunks.clear();
+        for (VoxelChunk* chunk : m_chunks) {
+            if (!chunk->isEmpty()) {
+                chunks.push_back(chunk);
+            }
+        }
+    }
+
+    int VoxelWorld::getChunkCount() const {
+        return static_cast<int>(m_chunks.size());
+    }
+
+    int VoxelWorld::getPendingMeshCount() const {
+        return m_meshThreadPool.getPendingCount();
+    }
+
+    void VoxelWorld::setRemeshBudget(float milliseconds) {
+        m_remeshBudgetMs = std::max(0.0f, milliseconds);
+    }
+
+    float VoxelWorld::getRemeshBudget() const {
+        return m_remeshBudgetMs;
+    }
 
-        auto yIt = xIt->second.find(chunkY);
-        if (yIt == xIt->second.end()) return nullptr;
+    RemeshStats VoxelWorld::getRemeshStats() const {
+        return m_remeshStats;
+    }
 
-        auto zIt = yIt->second.find(chunkZ);
-        if (zIt == yIt->second.end()) return nullptr;
+    CullStats VoxelWorld::getCullStats() const {
+        return m_cullStats;
+    }
 
-        return zIt->second;
+    void VoxelWorld::setCamera(renderer::Camera* camera) {
+        m_camera = camera;
+    }
+
+    void VoxelWorld::setMeshingMode(MeshingMode mode) {
+        if (m_meshingMode == mode) return;
+
+        m_meshingMode = mode;
+
+        // Apply to all chunks, which marks them dirty
+        for (VoxelChunk* chunk : m_chunks) {
+            chunk->setMeshingMode(mode);
+        }
+    }
+
+    MeshingMode VoxelWorld::getMeshingMode() const {
+        return m_meshingMode;
+    }
+
+    void VoxelWorld::setVoxelLayout(VoxelLayout layout) {
+        if (m_voxelLayout == layout) return;
+
+        m_voxelLayout = layout;
+
+        // Only the material storage moves, meshes stay valid
+        for (VoxelChunk* chunk : m_chunks) {
+            chunk->setVoxelLayout(layout);
+        }
+    }
+
+    VoxelLayout VoxelWorld::getVoxelLayout() const {
+        return m_voxelLayout;
+    }
+
+    VoxelChunk* VoxelWorld::getChunk(int chunkX, int chunkY, int chunkZ) {
+        return m_chunks.find(chunkX, chunkY, chunkZ);
     }
 
     VoxelChunk* VoxelWorld::getOrCreateChunk(int chunkX, int chunkY, int chunkZ) {
@@ -219,24 +793,221 @@ namespace voxel {
         if (chunk) return chunk;
 
         // Create new chunk
-        chunk = new VoxelChunk(chunkX, chunkY, chunkZ, CHUNK_SIZE);
-        m_chunks[chunkX][chunkY][chunkZ] = chunk;
+        chunk = m_chunkPool.create(chunkX, chunkY, chunkZ, &m_chunkPools, &m_dirtyChunks);
+        chunk->setMeshingMode(m_meshingMode);
+        chunk->setVoxelLayout(m_voxelLayout);
+        m_chunks.insert(chunkX, chunkY, chunkZ, chunk);
+
+        // Link it with the loaded chunks around it
+        for (int face = 0; face < 6; face++) {
+            VoxelChunk* neighbor = getChunk(
+                chunkX + VoxelChunk::NEIGHBOR_OFFSETS[face][0],
+                chunkY + VoxelChunk::NEIGHBOR_OFFSETS[face][1],
+                chunkZ + VoxelChunk::NEIGHBOR_OFFSETS[face][2]);
+
+            if (neighbor) {
+                chunk->setNeighbor(face, neighbor);
+                neighbor->setNeighbor(face ^ 1, chunk);
+            }
+        }
 
         return chunk;
     }
 
+    bool VoxelWorld::unloadChunk(int chunkX, int chunkY, int chunkZ) {
+        VoxelChunk* chunk = getChunk(chunkX, chunkY, chunkZ);
+        if (!chunk || chunk->isMeshInFlight()) return false;
+
+        // Faces of the neighbours that were hidden behind this chunk become visible
+        if (!chunk->isEmpty()) {
+            unsigned int neighborSections[6] = {
+                ChunkMesher::ALL_SECTIONS, ChunkMesher::ALL_SECTIONS,
+                ChunkMesher::ALL_SECTIONS, ChunkMesher::ALL_SECTIONS,
+                ChunkMesher::getSection(CHUNK_SIZE_Y - 1), ChunkMesher::getSection(0)
+            };
+            markNeighborSectionsDirty(chunk, neighborSections, false);
+        }
+
+        m_culler.remove(chunk);
+        if (chunk->isInDirtyList()) {
+            m_dirtyChunks.erase(std::find(m_dirtyChunks.begin(), m_dirtyChunks.end(), chunk));
+        }
+
+        m_chunks.erase(chunkX, chunkY, chunkZ);
+        m_chunkPool.destroy(chunk);
+        return true;
+    }
+
+    bool VoxelWorld::createMeshJob(VoxelChunk* chunk, ChunkMeshJob& job, bool async) {
+        job.chunkX = chunk->getChunkX();
+        job.chunkY = chunk->getChunkY();
+        job.chunkZ = chunk->getChunkZ();
+        job.revision = chunk->createMeshInput(job.input, async, m_materialTable);
+
+        // Empty chunks have no faces at all
+        if (chunk->isEmpty()) return false;
+
+        bool enclosed = chunk->isFull();
+
+        for (int face = 0; face < 6; face++) {
+            VoxelChunk* neighbor = chunk->getNeighbor(face);
+
+            // The neighbour's opposite face touches this chunk
+            if (neighbor) {
+                std::vector<RowMask>& slice = job.input.neighbors[face];
+                neighbor->copyBoundarySlice(face ^ 1, slice, m_materialTable);
+
+                // Transparent voxels compare materials across the border
+                if (!job.input.opaqueRows.empty()) {
+                    neighbor->copyBoundaryMaterials(face ^ 1, job.input.neighborMaterials[face]);
+                }
+                int width = ChunkMesher::getPlaneWidth(face);
+                RowMask fullRow = (width == 64) ? ~RowMask(0) : (RowMask(1) << width) - 1;
+                enclosed = enclosed && std::all_of(slice.begin(), slice.end(),
+                    [fullRow](RowMask row) { return row == fullRow; });
+            }
+            else {
+                enclosed = false;
+            }
+        }
+
+        // Solid chunks buried in solid neighbours have no visible faces either
+        return !enclosed;
+    }
+
+    bool VoxelWorld::applyChunkMesh(VoxelChunk* chunk, const ChunkMeshOutput& output, unsigned int revision) {
+        bool applied = chunk->applyMesh(output, revision);
+
+        glm::vec3 min, max;
+        if (chunk->getMeshBounds(min, max)) {
+            m_culler.setBox(chunk, min, max);
+        }
+        else {
+            m_culler.remove(chunk);
+        }
+
+        return applied;
+    }
+
+    void VoxelWorld::applyEmptyMesh(VoxelChunk* chunk, const ChunkMeshJob& job) {
+        // No section can have faces, so replace them all: the chunk gives up its geometry
+        // range and drops out of the culler instead of keeping slots of degenerate quads
+        ChunkMeshOutput& output = m_immediateOutput;
+        output.sections = ChunkMesher::ALL_SECTIONS;
+        output.sectionVertices.resize(ChunkMesher::SECTION_COUNT);
+        output.boundsMin = job.input.boundsMin;
+        output.boundsMax = job.input.boundsMax;
+        for (auto& vertices : output.sectionVertices) {
+            vertices.clear();
+        }
+        applyChunkMesh(chunk, output, job.revision);
+    }
+
+    void VoxelWorld::rebuildChunkMeshNow(VoxelChunk* chunk) {
+        ChunkMeshJob& job = m_immediateJob;
+        ChunkMeshOutput& output = m_immediateOutput;
+        if (!createMeshJob(chunk, job, false)) {
+            applyEmptyMesh(chunk, job);
+            return;
+        }
+        m_mesher.build(job.input, output);
+
+        // A section that outgrew its slot marks the whole chunk dirty, rebuild it right away
+        if (!applyChunkMesh(chunk, output, job.revision)) {
+            createMeshJob(chunk, job, false);
+            m_mesher.build(job.input, output);
+            applyChunkMesh(chunk, output, job.revision);
+        }
+    }
+
+    int VoxelWorld::applyFinishedMeshes(double frameStart, float deadlineMs) {
+        int uploaded = 0;
+        ChunkMeshResult result;
+
+        // Always upload at least one mesh so a tight budget cannot stall the queue
+        while ((uploaded == 0 || getTimeMs() - frameStart < deadlineMs) &&
+            m_meshThreadPool.popResult(result)) {
+            VoxelChunk* chunk = getChunk(result.chunkX, result.chunkY, result.chunkZ);
+            if (chunk) {
+                applyChunkMesh(chunk, result.output, result.revision);
+            }
+            m_meshThreadPool.recycleOutput(std::move(result.output));
+            uploaded++;
+        }
+
+        return uploaded;
+    }
+
+    float VoxelWorld::getRemeshPriority(const VoxelChunk* chunk) const {
+        if (!m_camera) return 0.0f;
+
+        glm::vec3 size(CHUNK_SIZE_X, CHUNK_SIZE_Y, CHUNK_SIZE_Z);
+        glm::vec3 center = (glm::vec3(chunk->getChunkX(), chunk->getChunkY(), chunk->getChunkZ()) + 0.5f) * size;
+        glm::vec3 toChunk = center - m_camera->getPosition();
+        float distance = glm::length(toChunk);
+
+        // Chunks the camera is inside or looking towards come first; those behind
+        // are weighted as if they were several times further away
+        bool inView = distance < glm::length(size) * 0.5f ||
+            glm::dot(toChunk / distance, m_camera->getFront()) > 0.5f;
+
+        return inView ? distance : distance * 4.0f;
+    }
+
+    bool VoxelWorld::setChunkVoxel(VoxelChunk* chunk, int localX, int localY, int localZ,
+        bool value, bool immediate) {
+        // Adding a voxel that is already solid keeps its material
+        if (chunk->hasVoxel(localX, localY, localZ) == value) return false;
+        if (!chunk->writeMaterial(localX, localY, localZ, value ? DEFAULT_MATERIAL : AIR_MATERIAL)) return false;
+
+        markVoxelChanged(chunk, localX, localY, localZ, immediate);
+        return true;
+    }
+
+    void VoxelWorld::markVoxelChanged(VoxelChunk* chunk, int localX, int localY, int localZ, bool immediate) {
+        unsigned int neighborSections[6] = { 0, 0, 0, 0, 0, 0 };
+        collectNeighborSections(localY, localZ, RowMask(1) << localX, neighborSections);
+
+        chunk->markSectionsDirty(chunk->getAffectedSections(localY), immediate);
+        markNeighborSectionsDirty(chunk, neighborSections, immediate);
+    }
+
+    void VoxelWorld::collectNeighborSections(int localY, int localZ, RowMask changed,
+        unsigned int neighborSections[6]) const {
+        if (!changed) return;
+
+        unsigned int section = ChunkMesher::getSection(localY);
+
+        // Border voxels also change the touching section of the neighbour
+        if (localZ == 0) neighborSections[0] |= section;
+        if (localZ == CHUNK_SIZE_Z - 1) neighborSections[1] |= section;
+        if (changed & 1) neighborSections[2] |= section;
+        if ((changed >> (CHUNK_SIZE_X - 1)) & 1) neighborSections[3] |= section;
+        if (localY == 0) neighborSections[4] |= ChunkMesher::getSection(CHUNK_SIZE_Y - 1);
+        if (localY == CHUNK_SIZE_Y - 1) neighborSections[5] |= ChunkMesher::getSection(0);
+    }
+
+    void VoxelWorld::markNeighborSectionsDirty(VoxelChunk* chunk, const unsigned int neighborSections[6],
+        bool immediate) {
+        for (int face = 0; face < 6; face++) {
+            VoxelChunk* neighbor = chunk->getNeighbor(face);
+            if (neighborSections[face] && neighbor) {
+                neighbor->markSectionsDirty(neighborSections[face], immediate);
+            }
+        }
+    }
+
     void VoxelWorld::worldToChunkCoords(int worldX, int worldY, int worldZ,
         int& chunkX, int& chunkY, int& chunkZ,
         int& localX, int& localY, int& localZ) const {
-        // Handle negative coordinates correctly
-        chunkX = (worldX < 0 && worldX % CHUNK_SIZE != 0) ? (worldX / CHUNK_SIZE - 1) : (worldX / CHUNK_SIZE);
-        chunkY = (worldY < 0 && worldY % CHUNK_SIZE != 0) ? (worldY / CHUNK_SIZE - 1) : (worldY / CHUNK_SIZE);
-        chunkZ = (worldZ < 0 && worldZ % CHUNK_SIZE != 0) ? (worldZ / CHUNK_SIZE - 1) : (worldZ / CHUNK_SIZE);
-
-        // Calculate local coordinates
-        localX = worldX - chunkX * CHUNK_SIZE;
-        localY = worldY - chunkY * CHUNK_SIZE;
-        localZ = worldZ - chunkZ * CHUNK_SIZE;
+        // Arithmetic shifts floor negative coordinates, masks give the matching local offset
+        chunkX = worldX >> WorldChunkShape::SHIFT_X;
+        chunkY = worldY >> WorldChunkShape::SHIFT_Y;
+        chunkZ = worldZ >> WorldChunkShape::SHIFT_Z;
+
+        localX = worldX & WorldChunkShape::MASK_X;
+        localY = worldY & WorldChunkShape::MASK_Y;
+        localZ = worldZ & WorldChunkShape::MASK_Z;
     }
 
 } // namespace voxel
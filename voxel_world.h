@@ -1,7 +1,13 @@
 #pragma once
 
 #include "voxel_system.h"
-#include <unordered_map>
+#include "chunk_map.h"
+#include "voxel_chunk.h"
+#include "block_pool.h"
+#include "chunk_mesh_thread_pool.h"
+#include "chunk_culler.h"
+#include <functional>
+#include <utility>
 #include <vector>
 #include <glm/glm.hpp>
 
@@ -17,6 +23,29 @@ namespace voxel {
 
     class VoxelWorld {
     public:
+        // Cursor for runs of voxel queries and edits. Remembers the last chunk it touched
+        // and steps to adjacent chunks through their neighbour pointers, so coherent
+        // access patterns (raycasts, neighbour scans, edit loops) rarely hit the chunk map.
+        // Keep accessors short-lived; they do not track chunks being destroyed.
+        class Accessor {
+        public:
+            explicit Accessor(VoxelWorld& world);
+
+            bool hasVoxel(int x, int y, int z);
+            // Same as VoxelWorld::addVoxel / removeVoxel
+            bool setVoxel(int x, int y, int z, bool value, bool immediate = false);
+
+            // nullptr if the chunk is not loaded
+            VoxelChunk* getChunk(int chunkX, int chunkY, int chunkZ);
+
+        private:
+            VoxelWorld& m_world;
+            VoxelChunk* m_chunk;
+            int m_chunkX;
+            int m_chunkY;
+            int m_chunkZ;
+        };
+
         VoxelWorld();
         ~VoxelWorld();
 
@@ -26,30 +55,183 @@ namespace voxel {
         void render(renderer::Renderer* renderer, renderer::Camera* camera);
 
         // Voxel manipulation
-        bool addVoxel(int x, int y, int z);
-        bool removeVoxel(int x, int y, int z);
-        bool toggleVoxel(int x, int y, int z);
+        bool addVoxel(int x, int y, int z, bool immediate = false);
+        bool removeVoxel(int x, int y, int z, bool immediate = false);
+        bool toggleVoxel(int x, int y, int z, bool immediate = false);
         bool hasVoxel(int x, int y, int z) const;
 
+        // Materials, AIR_MATERIAL removes the voxel. addVoxel uses DEFAULT_MATERIAL.
+        bool setVoxelMaterial(int x, int y, int z, MaterialId material, bool immediate = false);
+        MaterialId getVoxelMaterial(int x, int y, int z) const;
+
+        // Materials are opaque by default; see MaterialTable for the culling rule
+        void setMaterialTransparent(MaterialId material, bool transparent);
+        bool isMaterialTransparent(MaterialId material) const;
+
+        // Batched edits: sorted by chunk, applied with one chunk lookup per chunk, and every
+        // touched chunk and neighbour marked dirty once. Edits write their material, later
+        // edits to the same voxel win. Returns the number of voxels that changed.
+        int applyEdits(const std::vector<VoxelEdit>& edits, bool immediate = false);
+
+        // Shape brushes, rasterized chunk by chunk into bit spans per row. Chunks a shape
+        // covers completely are filled in one step. Voxels are inside a shape when their
+        // centre is. Each returns the number of voxels that changed.
+        int fillBox(const VoxelPos& min, const VoxelPos& max, bool value = true, bool immediate = false,
+            MaterialId material = DEFAULT_MATERIAL);
+        int fillSphere(const glm::vec3& center, float radius, bool value = true, bool immediate = false,
+            MaterialId material = DEFAULT_MATERIAL);
+        int carveSphere(const glm::vec3& center, float radius, bool immediate = false);
+        // Upright cylinder standing on base (the centre of its bottom face)
+        int fillCylinder(const glm::vec3& base, float radius, int height, bool value = true, bool immediate = false,
+            MaterialId material = DEFAULT_MATERIAL);
+        int drawLine(const VoxelPos& from, const VoxelPos& to, bool value = true, bool immediate = false,
+            MaterialId material = DEFAULT_MATERIAL);
+        // Changes every voxel of material from inside the box to material to (either may be air)
+        int replace(const VoxelPos& min, const VoxelPos& max, MaterialId from, MaterialId to, bool immediate = false);
+
         // Raycast
         bool raycast(const glm::vec3& origin, const glm::vec3& direction,
             VoxelPos& hitPos, FaceDirection& hitFace, float maxDistance = 10.0f);
 
+        // Occupancy queries, answered from the per-chunk counts in O(loaded chunks)
+        int64_t getVoxelCount() const;
+        // Inclusive world bounds of all solid voxels, false when the world is empty
+        bool getBounds(VoxelPos& min, VoxelPos& max) const;
+        void getNonEmptyChunks(std::vector<VoxelChunk*>& chunks) const;
+        int getChunkCount() const;
+
+        // Chunk meshes being built on worker threads
+        int getPendingMeshCount() const;
+
+        // Main thread milliseconds per frame spent snapshotting and uploading chunk meshes.
+        // Chunks with immediate edits are always remeshed regardless of the budget.
+        void setRemeshBudget(float milliseconds);
+        float getRemeshBudget() const;
+        RemeshStats getRemeshStats() const;
+
+        // Chunks drawn and frustum culled by the last render()
+        CullStats getCullStats() const;
+
+        // Camera used to prioritize remeshing of nearby, visible chunks
+        void setCamera(renderer::Camera* camera);
+
+        // Meshing mode (applies to every chunk, existing chunks are remeshed)
+        void setMeshingMode(MeshingMode mode);
+        MeshingMode getMeshingMode() const;
+
+        // Per-voxel storage layout (applies to every chunk, existing chunks are re-encoded)
+        void setVoxelLayout(VoxelLayout layout);
+        VoxelLayout getVoxelLayout() const;
+
         // Chunk management
         VoxelChunk* getChunk(int chunkX, int chunkY, int chunkZ);
         VoxelChunk* getOrCreateChunk(int chunkX, int chunkY, int chunkZ);
+        // Destroys a loaded chunk and returns its memory and mesh to the pools. Returns false
+        // if the chunk is not loaded or still has a mesh job in flight (try again later).
+        // Accessors that may have cached the chunk must not be used afterwards.
+        bool unloadChunk(int chunkX, int chunkY, int chunkZ);
 
-        // Constants
-        static const int CHUNK_SIZE = 16;
+        // Chunk extents, see WorldChunkShape
+        static constexpr int CHUNK_SIZE_X = WorldChunkShape::SIZE_X;
+        static constexpr int CHUNK_SIZE_Y = WorldChunkShape::SIZE_Y;
+        static constexpr int CHUNK_SIZE_Z = WorldChunkShape::SIZE_Z;
 
     private:
+        // Batched edit split into chunk and local coordinates
+        struct PendingEdit {
+            uint64_t chunkKey;
+            int chunkX;
+            int chunkY;
+            int chunkZ;
+            uint8_t localX;
+            uint8_t localY;
+            uint8_t localZ;
+            MaterialId material;
+            // Position in the submitted list, so later edits to a voxel still win
+            uint32_t order;
+        };
+
+        // Inclusive x range of a shape in world row (y, z), false if the row is empty
+        typedef std::function<bool(int y, int z, int& minX, int& maxX)> RowSpanFunction;
+
+        // Writes material to a shape given by its row spans, clipped to the box [min, max].
+        // When replacing, only voxels that currently have material from are written.
+        int fillShape(const VoxelPos& min, const VoxelPos& max, const RowSpanFunction& rowSpan,
+            MaterialId material, bool immediate, bool replacing = false, MaterialId from = AIR_MATERIAL);
+
         // Convert world position to chunk coordinates
         void worldToChunkCoords(int worldX, int worldY, int worldZ,
             int& chunkX, int& chunkY, int& chunkZ,
             int& localX, int& localY, int& localZ) const;
 
-        // Chunks storage
-        std::unordered_map<int, std::unordered_map<int, std::unordered_map<int, VoxelChunk*>>> m_chunks;
+        // Snapshots a dirty chunk, including its neighbours' border slices.
+        // async marks the chunk as having a job in flight on the workers.
+        // Returns false for chunks without visible faces (empty, or solid and enclosed
+        // by solid neighbours), which need no meshing.
+        bool createMeshJob(VoxelChunk* chunk, ChunkMeshJob& job, bool async);
+
+        // Applies a mesh to its chunk and refreshes the chunk's culling box
+        bool applyChunkMesh(VoxelChunk* chunk, const ChunkMeshOutput& output, unsigned int revision);
+
+        // Applies the result for a job that needed no meshing
+        void applyEmptyMesh(VoxelChunk* chunk, const ChunkMeshJob& job);
+
+        // Meshes a chunk on the calling thread and uploads it right away
+        void rebuildChunkMeshNow(VoxelChunk* chunk);
+
+        // Uploads meshes finished by the workers until the deadline (in ms since frameStart) passes
+        int applyFinishedMeshes(double frameStart, float deadlineMs);
+
+        // Lower values are remeshed first: distance to the camera, with chunks in view preferred
+        float getRemeshPriority(const VoxelChunk* chunk) const;
+
+        // Sets a voxel in a loaded chunk and marks what needs remeshing
+        bool setChunkVoxel(VoxelChunk* chunk, int localX, int localY, int localZ, bool value, bool immediate);
+        void markVoxelChanged(VoxelChunk* chunk, int localX, int localY, int localZ, bool immediate);
+
+        // Adds the neighbour sections whose faces depend on the changed bits of
+        // row (localY, localZ), per face, to neighborSections
+        void collectNeighborSections(int localY, int localZ, RowMask changed, unsigned int neighborSections[6]) const;
+        void markNeighborSectionsDirty(VoxelChunk* chunk, const unsigned int neighborSections[6], bool immediate);
+
+        // Chunks storage, keyed by packed chunk coordinates. Chunk objects, their rows and
+        // meshes come from pools that shutdown() releases in bulk.
+        ChunkMap m_chunks;
+        ObjectPool<VoxelChunk> m_chunkPool;
+        ChunkPools m_chunkPools;
+
+        MeshingMode m_meshingMode;
+        VoxelLayout m_voxelLayout;
+        MaterialTable m_materialTable;
+
+        // Background chunk meshing
+        ChunkMeshThreadPool m_meshThreadPool;
+        ChunkMesher m_mesher;
+
+        // Buffers reused by immediate remeshes on the main thread
+        ChunkMeshJob m_immediateJob;
+        ChunkMeshOutput m_immediateOutput;
+
+        // Remesh scheduling; update() only looks at the chunks on the dirty list
+        DirtyChunkList m_dirtyChunks;
+        renderer::Camera* m_camera;
+        float m_remeshBudgetMs;
+        RemeshStats m_remeshStats;
+        // Cleared, not freed, every update so it stays at its largest size
+        std::vector<std::pair<float, VoxelChunk*>> m_remeshQueue;
+
+        // Frustum culling; boxes of the chunks with meshes, tightened to their voxels
+        ChunkCuller m_culler;
+        std::vector<VoxelChunk*> m_visibleChunks;
+        std::vector<renderer::ChunkDraw> m_chunkDraws;
+        CullStats m_cullStats;
+
+        // Scratch space for applyEdits, and the voxels drawLine hands to it
+        std::vector<PendingEdit> m_editBuffer;
+        std::vector<VoxelEdit> m_lineEdits;
+
+        // Scratch space for fillShape, one row mask per chunk row
+        std::vector<RowMask> m_shapeRows;
     };
 
 } // namespace voxel